@@ -13,6 +13,9 @@
 #		include "graphics/graphics_RenderSystemExt.h"
 
 #		include "graphics/graphics_CommandCache.h"
+#		include "graphics/graphics_DrawStatistics.h"
+#		include "graphics/graphics_FrameArena.h"
+#		include "graphics/graphics_FrameProfiler.h"
 #	endif	// __cplusplus
 
 #else
@@ -0,0 +1,131 @@
+#ifndef GRAPHICS_ALLOCATION_REGISTRY_H_
+#define GRAPHICS_ALLOCATION_REGISTRY_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	// Number of memory regions tracked (FCRAM, VRAM-A and VRAM-B).
+	const u32 GRAPHICS_MEMORY_AREA_NUM = 3;
+	// Number of buffer purposes tracked (<tt>NN_GX_MEM_SYSTEM</tt> to <tt>NN_GX_MEM_COMMANDBUFFER</tt>).
+	const u32 GRAPHICS_MEMORY_AIM_NUM = 6;
+
+	/*!
+		@brief Defines the order of the blocks printed by <tt>PrintMemoryLiveBlocks</tt>.
+	*/
+	enum MemoryBlockSortKey
+	{
+		MEMORY_BLOCK_SORT_KEY_SIZE,	   // Largest first.
+		MEMORY_BLOCK_SORT_KEY_ADDRESS, // Lowest address first.
+		MEMORY_BLOCK_SORT_KEY_SERIAL   // Oldest allocation first.
+	};
+
+	/*!
+		@brief Stores the live memory of each memory region and purpose at a point in time.
+
+			   Take a snapshot before and after a scene or a soak test loop and compare them to find leaks.
+	*/
+
+	class MemorySnapshot
+	{
+	public:
+		MemorySnapshot(void);
+		virtual ~MemorySnapshot(void);
+
+	public:
+		// Gets the total live size of all regions and purposes.
+		size_t GetTotalLiveSize(void) const;
+		// Checks whether the live sizes of every region and purpose are the same as those of <tt>rhs</tt>.
+		bool HasSameLiveSize(const MemorySnapshot& rhs) const;
+		void Print(void) const;
+		// Print the change of each region and purpose since <tt>before</tt>.
+		void PrintDifference(const MemorySnapshot& before) const;
+
+	public:
+		// Serial number of the next allocation when the snapshot was taken.
+		u32	   m_Serial;
+		size_t m_LiveSizeArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+		u32	   m_LiveNumArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+		size_t m_PeakSizeArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+	};
+
+	namespace detail {
+		// Maximum number of slots of the registry table. It must be a power of two; up to three quarters of it are used.
+		const u32 ALLOCATION_REGISTRY_SLOT_NUM_LOG2 = 10;
+		const u32 ALLOCATION_REGISTRY_SLOT_NUM		= (1 << ALLOCATION_REGISTRY_SLOT_NUM_LOG2);
+		const u32 ALLOCATION_REGISTRY_BLOCK_MAX_NUM = (ALLOCATION_REGISTRY_SLOT_NUM / 4) * 3;
+
+		// Gets the index of a memory region, or <tt>GRAPHICS_MEMORY_AREA_NUM</tt> if it is invalid.
+		u32 GetMemoryAreaIndex(const GLenum area);
+		// Gets the index of a buffer purpose, or <tt>GRAPHICS_MEMORY_AIM_NUM</tt> if it is invalid.
+		u32			GetMemoryAimIndex(const GLenum aim);
+		const char* GetMemoryAreaName(const u32 areaIndex);
+		const char* GetMemoryAimName(const u32 aimIndex);
+
+		/*!
+			@brief Records every live block allocated by the memory manager.
+
+				   Blocks are kept in a hash table keyed by address, so registering and unregistering a block is O(1).
+		*/
+		class AllocationRegistry : private nn::util::NonCopyable<AllocationRegistry>
+		{
+		public:
+			AllocationRegistry(void);
+			virtual ~AllocationRegistry(void);
+
+		public:
+			void Initialize(void);
+			void Finalize(void);
+
+		public:
+			void Register(const GLenum area, const GLenum aim, const GLuint id, const void* addr, const size_t size);
+			// Returns <tt>false</tt> if <tt>addr</tt> was not registered.
+			bool Unregister(const void* addr);
+
+		public:
+			void GetSnapshot(MemorySnapshot& snapshot) const;
+			/*!
+				@brief Prints the live blocks.
+
+				@param[in] maxNum  Specifies the maximum number of blocks to print.
+				@param[in] sortKey  Specifies the order of the blocks.
+				@param[in] pSince  Specifies a snapshot; only the blocks allocated after it are printed. <tt>NULL</tt> prints all blocks.
+			*/
+			void PrintLiveBlocks(const u32 maxNum, const MemoryBlockSortKey sortKey, const MemorySnapshot* pSince) const;
+			u32	 GetUntrackedNum(void) const;
+
+		protected:
+			struct Entry
+			{
+				uptr   m_Addr;
+				size_t m_Size;
+				u32	   m_Serial;
+				GLuint m_Id;
+				u8	   m_AreaIndex;
+				u8	   m_AimIndex;
+				u8	   m_Padding[2];
+			};
+
+		protected:
+			u32	 GetHomeSlot(const uptr addr) const;
+			bool IsBefore(const Entry& lhs, const Entry& rhs, const MemoryBlockSortKey sortKey) const;
+
+		protected:
+			bool m_InitializeFlag;
+			u8	 m_Padding[3];
+
+			u32 m_EntryNum;
+			u32 m_NextSerial;
+			u32 m_UntrackedNum;
+
+			size_t m_LiveSizeArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+			u32	   m_LiveNumArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+			size_t m_PeakSizeArray2d[GRAPHICS_MEMORY_AREA_NUM][GRAPHICS_MEMORY_AIM_NUM];
+
+			Entry m_EntryArray[ALLOCATION_REGISTRY_SLOT_NUM];
+		};
+	}  // namespace detail
+
+}}	// namespace nn::graphics
+
+#endif
@@ -50,6 +50,13 @@ namespace nn { namespace graphics {
 		*/
 		virtual bool Use(void);
 
+		/*!
+		:private
+
+		@brief Sets the state that the shader program object always uses.
+		*/
+		virtual void SetupState(void);
+
 	protected:
 		virtual void InitializeVertexAttributes(void);
 	};
@@ -65,6 +65,31 @@ namespace nn { namespace graphics {
 								const GLsizei bufferSize,
 								const u32	  uniformFloatRegIndex,
 								u32*		  uniformOffsetArray);
+
+		// Maximum number of register writes merged into one burst command.
+		const u32 COMMAND_BUFFER_MAX_BURST_NUM = 128;
+
+		/*!
+		:private
+
+		@brief Removes register writes whose value equals the value last written by the same buffer and merges adjacent
+		single writes to consecutive registers into burst commands. The buffer is rewritten in place.
+
+		@param[in,out] bufferAddress		Start address of the 3D command buffer.
+		@param[in]	   bufferSize			Size of the 3D command buffer in bytes.
+		@param[in,out] barrierOffsetArray	Offsets that must stay on a command boundary. They are remapped to the new layout.
+		@param[in]	   barrierOffsetNum		Number of elements in <tt>barrierOffsetArray</tt>.
+		@param[out]	   removedNum			Number of register writes removed.
+		@param[out]	   mergedNum			Number of single commands merged into burst commands.
+
+		@return Size of the rewritten 3D command buffer in bytes.
+		*/
+		GLsizei OptimizeCommandBuffer(u8*			bufferAddress,
+									  const GLsizei bufferSize,
+									  u32*			barrierOffsetArray,
+									  const u32		barrierOffsetNum,
+									  u32*			removedNum,
+									  u32*			mergedNum);
 	}  // namespace detail
 
 	enum
@@ -109,6 +134,9 @@ namespace nn { namespace graphics {
 		void SaveCommandBufferStartOffset(const u32 modelIndex);
 		// End saving the command list.
 		void EndSave(void);
+		// Remove redundant register writes from the saved command list. Call after EndSave(). Returns false and leaves the list
+		// unchanged when it contains requests.
+		bool Optimize(void);
 
 	public:
 		// Update the vertex shader floating point matrix values specified by the array index of the specified matrix.
@@ -119,6 +147,10 @@ namespace nn { namespace graphics {
 	public:
 		void Print(void);
 
+	protected:
+		// Search the saved 3D command buffer for the offsets of the vertex shader uniform matrices.
+		void UpdateVSUniformOffsets(void);
+
 	protected:
 		u32 m_State;
 
@@ -139,6 +171,8 @@ namespace nn { namespace graphics {
 		GLuint	m_CommandRequestBeginId;
 		GLsizei m_CommandRequestSize;
 		u8*		m_CommandBufferAddr;
+		u32		m_RemovedCommandNum;
+		u32		m_MergedCommandNum;
 
 		// Array used to store the 3D command buffer offset of the vertex shader uniform matrix.
 		detail::VertexShaderUniformMatrix m_VertexShaderUniformMatrixArray2d[GRAPHICS_MAX_COMMAND_CACHE_MODELS_NUM]
@@ -1,11 +1,20 @@
 #ifndef GRAPHICS_COMMAND_LIST_H_
 #define GRAPHICS_COMMAND_LIST_H_
 
+#include "graphics/graphics_FrameProfiler.h"
 #include "graphics/graphics_Utility.h"
 
 namespace nn { namespace graphics {
 
-	const u32 GRAPHICS_COMMAND_LIST_NUM = 1;
+	// Maximum number of command lists in the ring. The CPU records into one list while the GPU executes the other. The GPU runs
+	// one command list at a time and a list is only run after the previous one is done, so a third list would add no overlap.
+	const u32 GRAPHICS_COMMAND_LIST_NUM = 2;
+
+	// Number of frames kept to compute the command list usage statistics.
+	const u32 GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM = 64;
+	// Granularity used when the command list storage is resized.
+	const u32 GRAPHICS_COMMAND_LIST_BUFFER_SIZE_ALIGNMENT = 0x1000;
+	const u32 GRAPHICS_COMMAND_LIST_REQUEST_NUM_ALIGNMENT = 16;
 
 	/*!
 		@brief Represents a command list.
@@ -18,7 +27,20 @@ namespace nn { namespace graphics {
 		virtual ~CommandList(void);
 
 	public:
-		void Initialize(const GLsizei bufferSize, const GLsizei requestNum, const bool serialRunMode = false);
+		/*!
+		@brief Initializes the command lists.
+
+		@param[in] bufferSize	  Size of the 3D command buffer of each command list.
+		@param[in] requestNum	  Number of command requests that can be queued in each command list.
+		@param[in] serialRunMode  Specifies whether the command list runs while commands are being stored. Only used when
+								  <tt>commandListNum</tt> is 1.
+		@param[in] commandListNum Number of command lists in the ring, 1 or 2. When 2, <tt>Run</tt> returns without waiting and
+								  the next frame is stored in another command list while the GPU executes the current one.
+		*/
+		void Initialize(const GLsizei bufferSize,
+						const GLsizei requestNum,
+						const bool	  serialRunMode	 = false,
+						const u32	  commandListNum = 1);
 		void Finalize(void);
 
 	public:
@@ -26,21 +48,61 @@ namespace nn { namespace graphics {
 
 	protected:
 		void RunSingle(void);
+		void RunMultiple(void);
+		void WaitCommandList(const u32 commandListIndex);
+		// Record the buffer size and request count used by the command list being run.
+		void RecordUsage(void);
+		// Reallocate the storage of the bound command list when its size is out of date. The list must be empty.
+		void UpdateStorage(const u32 commandListIndex);
+		void BeginProfile(const FrameProfilerPhase phase);
+		void EndProfile(const FrameProfilerPhase phase);
 
 	public:
 		void Swap(void);
 		void Stop(void);
 		void Wait(void);
+		// Wait until the command list executed last is done. Returns immediately when no command list is executing.
+		void WaitRunning(void);
 		void Clear(void);
 
 	public:
 		void SetSerialRun(const bool flag);
+		u32	 GetCommandListNum(void) const;
+		// Submission and waits for the GPU are measured by the specified profiler. Specify <tt>NULL</tt> to stop measuring.
+		void SetFrameProfiler(FrameProfiler* frameProfilerPtr);
+
+	public:
+		/*!
+		@brief Enables resizing of the command list storage between frames.
+
+		When the used buffer size or request count of a frame leaves less than <tt>headroomPercent</tt> of the storage free,
+		the storage is grown before the next frame is stored. When the peak of the last
+		<tt>GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM</tt> frames fits in half of the storage with the headroom, it is shrunk.
+
+		@param[in] enable		   Specifies whether the storage is resized.
+		@param[in] headroomPercent Free space to keep, in percent of the storage (1 to 90).
+		*/
+		void SetAdaptiveStorage(const bool enable, const u32 headroomPercent = 25);
+
+		GLsizei GetBufferSize(void) const;
+		GLsizei GetRequestNum(void) const;
+		// Largest buffer size and request count used by a frame since the statistics were reset.
+		u32 GetPeakUsedBufferSize(void) const;
+		u32 GetPeakUsedRequestNum(void) const;
+		// Buffer size and request count not exceeded by <tt>percent</tt> % of the recorded frames.
+		u32 GetUsedBufferSizePercentile(const u32 percent) const;
+		u32 GetUsedRequestNumPercentile(const u32 percent) const;
+		void ResetStatistics(void);
+		void PrintStatistics(void) const;
 
 	protected:
 		bool m_InitializeFlag;
 		bool m_SerialRunFlag;
-		bool m_Padding[2];
+		// Set while the command list has been run and has not been waited on yet.
+		bool m_RunningFlagArray[GRAPHICS_COMMAND_LIST_NUM];
+		bool m_Padding[3];
 
+		u32 m_CommandListNum;
 		u32 m_StoreCommandListIndex;
 		u32 m_RunningCommandListIndex;
 
@@ -48,6 +110,23 @@ namespace nn { namespace graphics {
 
 		GLsizei m_BufferSize;
 		GLsizei m_RequestNum;
+		// Storage currently allocated for each command list.
+		GLsizei m_StorageBufferSizeArray[GRAPHICS_COMMAND_LIST_NUM];
+		GLsizei m_StorageRequestNumArray[GRAPHICS_COMMAND_LIST_NUM];
+
+		bool m_AdaptiveStorageFlag;
+		bool m_StatisticsPadding[3];
+		u32	 m_HeadroomPercent;
+
+		u32 m_UsedBufferSizeArray[GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM];
+		u32 m_UsedRequestNumArray[GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM];
+		u32 m_StatisticsFrameIndex;
+		u32 m_StatisticsFrameNum;
+		u32 m_PeakUsedBufferSize;
+		u32 m_PeakUsedRequestNum;
+		u32 m_ResizeCount;
+
+		FrameProfiler* m_FrameProfilerPtr;
 	};
 
 }}	// namespace nn::graphics
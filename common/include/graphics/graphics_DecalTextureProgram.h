@@ -51,6 +51,13 @@ namespace nn { namespace graphics {
 		*/
 		virtual bool Use(void);
 
+		/*!
+		:private
+
+		@brief Sets the state that the shader program object always uses.
+		*/
+		virtual void SetupState(void);
+
 	public:
 		/*!
 		:private
@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_DIRTY_REGION_H_
+#define GRAPHICS_DIRTY_REGION_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+	:private
+
+	@brief Specifies the number of columns of tiles that the <tt>DirtyRegion</tt> class divides the viewport into.
+	*/
+	const u32 DIRTY_REGION_TILE_COLUMN_NUM = 8;
+
+	/*!
+	:private
+
+	@brief Specifies the number of rows of tiles that the <tt>DirtyRegion</tt> class divides the viewport into.
+	*/
+	const u32 DIRTY_REGION_TILE_ROW_NUM = 8;
+
+	/*!
+	:private
+
+	@brief Specifies the number of tiles of the <tt>DirtyRegion</tt> class.
+	*/
+	const u32 DIRTY_REGION_TILE_NUM = DIRTY_REGION_TILE_COLUMN_NUM * DIRTY_REGION_TILE_ROW_NUM;
+
+	/*!
+	:private
+
+	@brief Specifies the initial value of the hashes of the <tt>DirtyRegion</tt> class.
+	*/
+	const u32 DIRTY_REGION_HASH_SEED = 2166136261U;
+
+	/*!
+		:private
+
+		@brief Finds the part of a display that changed since its previous frame.
+
+		Each tile of the viewport holds a hash of the primitives that touch it, in the order they were drawn. A tile whose hash is
+		not the one of the previous frame is damaged, and the damaged region is the rectangle covering all the damaged tiles.
+	*/
+
+	class DirtyRegion : private nn::util::NonCopyable<DirtyRegion>
+	{
+	public:
+		DirtyRegion(void);
+		virtual ~DirtyRegion(void);
+
+	public:
+		// A new size damages the whole viewport.
+		void SetWindowSize(const s32 windowWidth, const s32 windowHeight);
+		// Damages the whole viewport in the next frame.
+		void Invalidate(void);
+
+	public:
+		// Records a primitive within a bounding box in window coordinates. The hash covers everything that decides its pixels.
+		void Add(const f32 minWindowCoordinateX,
+				 const f32 minWindowCoordinateY,
+				 const f32 maxWindowCoordinateX,
+				 const f32 maxWindowCoordinateY,
+				 const u32 hash);
+		// Records a primitive that covers the whole viewport, such as a clear.
+		void AddAll(const u32 hash);
+		// Starts the next frame. Returns <tt>false</tt> if no tile is damaged, otherwise gets the damaged region in the coordinates
+		// of <tt>glScissor</tt>.
+		bool EndFrame(GLint& x, GLint& y, GLsizei& width, GLsizei& height);
+
+	public:
+		// Continues a hash with the bytes of the data.
+		static u32 Hash(const u32 hash, const void* pData, const size_t size);
+
+	protected:
+		void AddTiles(const s32 firstColumn, const s32 firstRow, const s32 lastColumn, const s32 lastRow, const u32 hash);
+
+	protected:
+		s32	 m_WindowWidth;
+		s32	 m_WindowHeight;
+		s32	 m_TileWidth;
+		s32	 m_TileHeight;
+		bool m_InvalidFlag;
+		u8	 m_Padding[3];
+
+		u32 m_TileHashArray[DIRTY_REGION_TILE_NUM];
+		u32 m_PreviousTileHashArray[DIRTY_REGION_TILE_NUM];
+	};
+
+}}	// namespace nn::graphics
+
+#endif
@@ -5,6 +5,8 @@
 
 namespace nn { namespace graphics {
 	const u32 GRAPHICS_DISPLAY_BUFFER_NUM = 2;
+	// Maximum number of display buffers per display. Two command lists in flight need one display buffer more than that.
+	const u32 GRAPHICS_MAX_DISPLAY_BUFFER_NUM = 3;
 
 	/*!
 		@brief Stores data for creating multiple display buffers.
@@ -65,7 +67,7 @@ namespace nn { namespace graphics {
 
 		GLenum m_TargetDisplay;
 		u32	   m_DisplayBufferNum;
-		GLuint m_DisplayBufferIdArray[GRAPHICS_DISPLAY_BUFFER_NUM];
+		GLuint m_DisplayBufferIdArray[GRAPHICS_MAX_DISPLAY_BUFFER_NUM];
 		u32	   m_CurrentBufferIndex;
 
 		u32 m_Width;
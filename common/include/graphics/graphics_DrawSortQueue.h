@@ -0,0 +1,129 @@
+#ifndef GRAPHICS_DRAW_SORT_QUEUE_H_
+#define GRAPHICS_DRAW_SORT_QUEUE_H_
+
+#include "graphics/graphics_TrianglesRenderData.h"
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+	:private
+
+	@brief Specifies the maximum number of entries that the <tt>DrawSortQueue</tt> class holds between two flushes. Consecutive
+	primitives of the same batch and layer share an entry.
+	*/
+	const u32 MAX_DRAW_SORT_ENTRIES_NUM = 2048;
+
+	/*!
+	:private
+
+	@brief Specifies the number of batches of the <tt>DrawSortQueue</tt> class. A batch is a render data drawn with one shader program
+	and texture.
+	*/
+	const u32 MAX_DRAW_SORT_BATCH_NUM = 32;
+
+	/*!
+	:private
+
+	@brief Specifies the number of layers of the <tt>DrawSortQueue</tt> class.
+	*/
+	const u32 MAX_DRAW_SORT_LAYER_NUM = 256;
+
+	/*!
+	:private
+
+	@brief Specifies the number of bits of a sort key, which are sorted 8 bits at a time.
+	*/
+	const u32 DRAW_SORT_KEY_BITS = 16;
+
+	/*!
+	:private
+
+	@brief Specifies the number of buckets of each pass of the radix sort.
+	*/
+	const u32 DRAW_SORT_RADIX_NUM = 256;
+
+	/*!
+	:private
+
+	@brief Holds a range of the indices of a batch, drawn in the order of its key.
+	*/
+	struct DrawSortEntry
+	{
+		u16 m_Key;
+		u8	m_BatchIndex;
+		u8	m_Padding[1];
+		u32 m_FirstIndex;
+		u32 m_IndicesNum;
+	};
+
+	/*!
+	:private
+
+	@brief Holds the render data, shader program and texture of a batch.
+	*/
+	struct DrawSortBatch
+	{
+		TrianglesRenderData* m_pRenderData;
+		u32					 m_ProgramId;
+		GLuint				 m_TextureId;
+		bool				 m_UseTextureFlag;
+		bool				 m_BlendFlag;
+		u8					 m_Padding[2];
+	};
+
+	/*!
+		:private
+
+		@brief Records the primitives packed between two flushes and sorts them by layer, shader program and texture.
+
+		The key of an entry is its layer, then its batch. Batches are numbered so that those of the same shader program are next to
+		each other. Blended batches are drawn after the opaque ones of their layer and are not sorted by batch, so that they stay in
+		the order they were packed. The sort is stable, so the packing order is the last part of every key.
+	*/
+
+	class DrawSortQueue : private nn::util::NonCopyable<DrawSortQueue>
+	{
+	public:
+		DrawSortQueue(void);
+		virtual ~DrawSortQueue(void);
+
+	public:
+		void Initialize(const u32 maxEntriesNum = MAX_DRAW_SORT_ENTRIES_NUM);
+		void Finalize(void);
+
+	public:
+		void SetBatch(const u32 batchIndex, TrianglesRenderData* pRenderData, const u32 programId, const bool blendFlag);
+		// The primitives of a textured batch are not drawn while its texture is 0.
+		void				 SetBatchTexture(const u32 batchIndex, const GLuint textureId);
+		const DrawSortBatch& GetBatch(const u32 batchIndex) const;
+
+	public:
+		void SetLayer(const u32 layer);
+		u32	 GetLayer(void) const;
+
+	public:
+		// Records the indices of a primitive in the current layer. Returns <tt>false</tt> if the queue is full.
+		bool Add(const u32 batchIndex, const u32 firstIndex, const u32 indicesNum);
+		// With <tt>submissionOrderFlag</tt>, the entries are only sorted by layer and keep the order they were added in.
+		void Sort(const bool submissionOrderFlag = false);
+		void Clear(void);
+
+	public:
+		u32					 GetEntriesNum(void) const;
+		const DrawSortEntry& GetSortedEntry(const u32 entryIndex) const;
+
+	protected:
+		DrawSortEntry* m_pEntryArray;
+		DrawSortEntry* m_pWorkEntryArray;
+		DrawSortEntry* m_pSortedEntryArray;
+		u32			   m_MaxEntriesNum;
+		u32			   m_EntriesNum;
+		u32			   m_Layer;
+
+		DrawSortBatch m_BatchArray[MAX_DRAW_SORT_BATCH_NUM];
+	};
+
+}}	// namespace nn::graphics
+
+#endif
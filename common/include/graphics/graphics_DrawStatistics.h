@@ -0,0 +1,73 @@
+#ifndef GRAPHICS_DRAW_STATISTICS_H_
+#define GRAPHICS_DRAW_STATISTICS_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+		@brief Contains the drawing counters of one frame.
+
+		The counters are accumulated between two calls of <tt>SwapBuffers</tt>.
+	*/
+
+	class DrawStatistics
+	{
+	public:
+		DrawStatistics(void);
+		virtual ~DrawStatistics(void);
+
+	public:
+		void Reset(void);
+
+		/*!
+		@brief Checks the counters against a budget.
+
+		@param[in] budget  Specifies the maximum value of each counter. A counter with a budget of 0 is not checked.
+		@return Returns <tt>true</tt> if no checked counter exceeds its budget; returns <tt>false</tt> otherwise.
+		*/
+		bool IsWithinBudget(const DrawStatistics& budget) const;
+		void Print(void) const;
+
+	public:
+		u32 m_DrawCallNum;
+		u32 m_TrianglesNum;
+		u32 m_SquaresNum;
+		u32 m_TextLength;
+		u32 m_TexturedTrianglesNum;
+
+		u32 m_UploadedVertexBytes;
+		u32 m_UploadedIndexBytes;
+
+		u32 m_ProgramBindNum;
+		u32 m_TextureBindNum;
+
+		// Primitives discarded because the capacity of the render data was reached.
+		u32 m_DroppedTrianglesNum;
+		u32 m_DroppedSquaresNum;
+		u32 m_DroppedTextLength;
+		u32 m_DroppedTexturedTrianglesNum;
+	};
+
+	/*!
+	:private
+
+	@brief Gets the counters of the frame being drawn.
+	*/
+	DrawStatistics& GetCurrentDrawStatistics(void);
+
+	/*!
+	@brief Gets the counters of the last frame completed by <tt>SwapBuffers</tt>.
+	*/
+	const DrawStatistics& GetDrawStatistics(void);
+
+	/*!
+	:private
+
+	@brief Completes the counters of the current frame and starts counting the next one.
+	*/
+	void SwapDrawStatistics(void);
+
+}}	// namespace nn::graphics
+
+#endif
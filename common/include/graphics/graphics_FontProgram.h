@@ -61,6 +61,13 @@ namespace nn { namespace graphics {
 		/*!
 		:private
 
+		@brief Sets the state that the shader program object always uses.
+		*/
+		virtual void SetupState(void);
+
+		/*!
+		:private
+
 		@brief Sets the rendering state after using the shader program object.
 		*/
 		virtual bool End(void);
@@ -0,0 +1,115 @@
+#ifndef GRAPHICS_FRAME_ARENA_H_
+#define GRAPHICS_FRAME_ARENA_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	// Maximum number of buffers of the frame arena. It matches the maximum number of command lists in flight.
+	const u32 GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM = 2;
+	// Default size of each buffer of the frame arena. The frame arena is only allocated when a title sets a size.
+	const u32 GRAPHICS_FRAME_ARENA_DEFAULT_BUFFER_SIZE = 0;
+
+	/*!
+		@brief Allocates short-lived memory that is valid until the command list it was used for has been run.
+
+			   An allocation is a pointer bump in the current buffer and memory is never freed one allocation at a time.
+			   <tt>Swap</tt> moves to the next buffer and discards everything allocated there, so with one buffer per command
+			   list in flight, the memory stays valid as long as the GPU may read it.
+	*/
+
+	class FrameArena : private nn::util::NonCopyable<FrameArena>
+	{
+	public:
+		FrameArena(void);
+		virtual ~FrameArena(void);
+
+	public:
+		/*!
+		@brief Allocates the buffers from the heap of the memory manager.
+
+		@param[in] bufferSize  Specifies the size of each buffer.
+		@param[in] bufferNum  Specifies the number of buffers, 1 to <tt>GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM</tt>.
+		*/
+		void Initialize(const size_t bufferSize, const u32 bufferNum);
+		void Finalize(void);
+
+	public:
+		/*!
+		@brief Allocates memory in the current buffer.
+
+		@param[in] size  Specifies the size to allocate.
+		@param[in] alignment  Specifies the alignment of the address. It must be a power of two.
+
+		@return Returns the address of the memory, or <tt>NULL</tt> if the current buffer is full.
+		*/
+		void* Allocate(const size_t size, const u32 alignment = 4);
+		// Move to the next buffer and discard its allocations.
+		void Swap(void);
+
+	public:
+		size_t GetBufferSize(void) const;
+		u32	   GetBufferNum(void) const;
+		size_t GetUsedSize(void) const;
+		size_t GetPeakUsedSize(void) const;
+		// Gets the number of allocations that failed because a buffer was full.
+		u32	 GetFailedAllocationNum(void) const;
+		void Print(void) const;
+
+	protected:
+		bool m_InitializeFlag;
+		bool m_Padding[3];
+
+		size_t m_BufferSize;
+		u32	   m_BufferNum;
+		u32	   m_BufferIndex;
+		u8*	   m_BufferAddrArray[GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM];
+		size_t m_UsedSize;
+		size_t m_PeakUsedSize;
+		u32	   m_FailedAllocationNum;
+	};
+
+	/*!
+	@brief Initializes the frame arena used by the graphics library.
+
+	This is called from within <tt>RenderSystem::Initialize</tt> when the frame arena size is not 0.
+
+	@param[in] bufferSize  Specifies the size of each buffer.
+	@param[in] bufferNum  Specifies the number of buffers.
+	*/
+	void InitializeFrameArena(const size_t bufferSize, const u32 bufferNum);
+
+	/*!
+	@brief Finalizes the frame arena used by the graphics library.
+	*/
+	void FinalizeFrameArena(void);
+
+	/*!
+	@brief Allocates memory that is valid until the command list of the current frame has been run.
+
+	Use this instead of <tt>Alloc</tt> for transient per-frame data. The memory must not be freed.
+
+	@param[in] size  Specifies the size to allocate.
+	@param[in] alignment  Specifies the alignment of the address. It must be a power of two.
+
+	@return Returns the address of the memory, or <tt>NULL</tt> if the arena is full or not initialized.
+	*/
+	void* AllocFrame(const size_t size, const u32 alignment = 4);
+
+	/*!
+	@brief Moves the frame arena to the next buffer.
+
+	:private
+
+	This is called from within <tt>SwapBuffers</tt> after the command list that used the next buffer has been run.
+	*/
+	void SwapFrameArena(void);
+
+	/*!
+	@brief Gets the frame arena used by the graphics library.
+	*/
+	FrameArena& GetFrameArena(void);
+
+}}	// namespace nn::graphics
+
+#endif
@@ -23,6 +23,7 @@ namespace nn { namespace graphics {
 		GLenum m_Format;
 		u32	   m_Width;
 		u32	   m_Height;
+		// <tt>GRAPHICS_MEMORY_AREA_AUTO</tt> lets the memory manager choose the VRAM bank.
 		GLenum m_Area;
 		GLenum m_Attachment;
 
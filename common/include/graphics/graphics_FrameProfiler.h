@@ -0,0 +1,83 @@
+#ifndef GRAPHICS_FRAME_PROFILER_H_
+#define GRAPHICS_FRAME_PROFILER_H_
+
+#include <nn/os/os_Tick.h>
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+		@brief Defines the phases of a frame measured by <tt>FrameProfiler</tt>.
+	*/
+	enum FrameProfilerPhase
+	{
+		FRAME_PROFILER_PHASE_BATCH,		  // CPU time outside the other phases (application and primitive batching).
+		FRAME_PROFILER_PHASE_FLUSH,		  // Packing and uploading primitives and issuing the GL draw calls.
+		FRAME_PROFILER_PHASE_SUBMIT,	  // Splitting and running the command list.
+		FRAME_PROFILER_PHASE_GPU_WAIT,	  // Waiting for the command list to be done.
+		FRAME_PROFILER_PHASE_VSYNC_WAIT,  // Waiting for the VSync.
+		FRAME_PROFILER_PHASE_FRAME,		  // Whole frame.
+		FRAME_PROFILER_PHASE_NUM
+	};
+
+	// Number of frames kept to compute the frame timing statistics.
+	const u32 GRAPHICS_FRAME_PROFILER_FRAME_NUM = 64;
+
+	/*!
+		@brief Measures the time spent in each phase of a frame with the system tick.
+	*/
+
+	class FrameProfiler : private nn::util::NonCopyable<FrameProfiler>
+	{
+	public:
+		FrameProfiler(void);
+		virtual ~FrameProfiler(void);
+
+	public:
+		void Initialize(void);
+		void Finalize(void);
+
+	public:
+		void SetEnabled(const bool flag);
+		bool IsEnabled(void) const;
+
+	public:
+		// Start measuring a phase. Phases other than <tt>FRAME_PROFILER_PHASE_BATCH</tt> must not overlap.
+		void Begin(const FrameProfilerPhase phase);
+		// Stop measuring a phase and add the elapsed time to the current frame.
+		void End(const FrameProfilerPhase phase);
+		// Close the current frame and store it in the ring of samples.
+		void EndFrame(void);
+		void Reset(void);
+
+	public:
+		u32 GetFrameNum(void) const;
+		// Statistics of a phase over the stored frames, in microseconds.
+		s64 GetMinMicroSeconds(const FrameProfilerPhase phase) const;
+		s64 GetAverageMicroSeconds(const FrameProfilerPhase phase) const;
+		s64 GetMaxMicroSeconds(const FrameProfilerPhase phase) const;
+		s64 GetPercentileMicroSeconds(const FrameProfilerPhase phase, const u32 percent) const;
+
+	public:
+		static const char* GetPhaseName(const FrameProfilerPhase phase);
+		void			   Print(void) const;
+
+	protected:
+		bool m_InitializeFlag;
+		bool m_EnabledFlag;
+		bool m_FrameStartedFlag;
+		bool m_Padding[1];
+
+		nn::os::Tick m_FrameBeginTick;
+		nn::os::Tick m_PhaseBeginTickArray[FRAME_PROFILER_PHASE_NUM];
+		s64			 m_CurrentTickArray[FRAME_PROFILER_PHASE_NUM];
+
+		s64 m_SampleTickArray2d[GRAPHICS_FRAME_PROFILER_FRAME_NUM][FRAME_PROFILER_PHASE_NUM];
+		u32 m_SampleIndex;
+		u32 m_SampleNum;
+	};
+
+}}	// namespace nn::graphics
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef GRAPHICS_GL_STATE_CACHE_H_
+#define GRAPHICS_GL_STATE_CACHE_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+	:private
+
+	@brief Specifies the number of capabilities whose enable state is cached: <tt>GL_BLEND</tt>, <tt>GL_CULL_FACE</tt> and
+	<tt>GL_COLOR_LOGIC_OP</tt>.
+	*/
+	const u32 GL_STATE_CACHE_CAPABILITY_NUM = 3;
+
+	/*!
+		:private
+
+		@brief Remembers the GL state set through it and skips the calls that would set the same value again.
+
+		The cache only knows the calls made through it. The application may change the GL state between two flushes, so the cache
+		is invalidated at the start of each flush and the first call of each kind after that is always issued.
+	*/
+
+	class GLStateCache
+	{
+	public:
+		GLStateCache(void);
+		virtual ~GLStateCache(void);
+
+	public:
+		// Forgets all the cached state.
+		void Invalidate(void);
+
+	public:
+		// Returns <tt>true</tt> if <tt>glUseProgram</tt> was issued.
+		bool UseProgram(const GLuint programId);
+		void ActiveTexture(const GLenum textureUnit);
+		// Returns <tt>true</tt> if <tt>glBindTexture</tt> was issued.
+		bool BindTexture2d(const GLuint textureId);
+		// Sets the magnification and minification filters of the bound 2D texture.
+		void SetTexture2dFilter(const GLenum magFilter, const GLenum minFilter);
+
+	public:
+		// Capabilities other than the cached ones are always set.
+		void SetEnable(const GLenum capability, const bool enableFlag);
+		void BlendFunc(const GLenum srcFactor, const GLenum dstFactor);
+		void BlendEquation(const GLenum mode);
+
+	protected:
+		bit32 m_ValidFlags;
+
+		GLuint m_ProgramId;
+		GLenum m_ActiveTexture;
+		GLuint m_TextureId;
+		GLuint m_FilterTextureId;
+		GLenum m_MagFilter;
+		GLenum m_MinFilter;
+
+		bool m_EnableFlagArray[GL_STATE_CACHE_CAPABILITY_NUM];
+		u8	 m_Padding[1];
+
+		GLenum m_BlendSrcFactor;
+		GLenum m_BlendDstFactor;
+		GLenum m_BlendEquation;
+	};
+
+	/*!
+	:private
+
+	@brief Gets the GL state cache used by the shader programs of the library.
+	*/
+	GLStateCache& GetGLStateCache(void);
+
+}}	// namespace nn::graphics
+
+#endif
@@ -4,12 +4,23 @@
 #include <nn/gx.h>
 #include <nn/util/util_NonCopyable.h>
 
+#include "graphics/graphics_DrawSortQueue.h"
 #include "graphics/graphics_TextsRenderData.h"
 #include "graphics/graphics_TrianglesRenderData.h"
 
 #include "graphics/graphics_ShaderManager.h"
 
 namespace nn { namespace graphics {
+	/*!
+	:private
+
+	@brief Specifies the batches of the draw sort queue that hold 2D triangles, quadrangles and text. The batches below them hold
+	textured triangles, so that those are drawn first in each layer.
+	*/
+	const u32 DRAW_SORT_BATCH_TRIANGLES = MAX_DRAW_SORT_BATCH_NUM - 3;
+	const u32 DRAW_SORT_BATCH_SQUARES	= MAX_DRAW_SORT_BATCH_NUM - 2;
+	const u32 DRAW_SORT_BATCH_TEXTS		= MAX_DRAW_SORT_BATCH_NUM - 1;
+
 	/*!
 		@brief  This class performs 2D drawing operations on the CTR.
 	*/
@@ -119,6 +130,24 @@ namespace nn { namespace graphics {
 		*/
 		virtual void DecrementDepth(void);
 
+		/*!
+		@brief Sets the layer of the primitives rendered in 2D from now on.
+
+		The layers are drawn in ascending order, whatever the depth of their primitives. In a layer, textured triangles are drawn
+		first, then triangles and quadrangles, then text. Text is blended, so it is drawn in the order it was rendered. The layer is
+		reset to 0 after each flush.
+
+		@param[in] layer  Specifies the layer ([0,<tt>MAX_DRAW_SORT_LAYER_NUM</tt>)).
+		*/
+		virtual void SetLayer(const u32 layer);
+
+		/*!
+		@brief Gets the layer of the primitives rendered in 2D.
+
+		@return Returns the layer.
+		*/
+		u32 GetLayer(void) const;
+
 	public:
 		/*!
 		@brief Sets the size when drawing a point in 2D.
@@ -127,6 +156,13 @@ namespace nn { namespace graphics {
 		*/
 		virtual void SetPointSize(const f32 pointSize);
 
+		/*!
+		@brief Gets the size used when drawing a point in 2D.
+
+		@return Returns the point size in pixels.
+		*/
+		f32 GetPointSize(void) const;
+
 		/*!
 		@brief Draws a 2D point specified in window coordinates.
 
@@ -145,6 +181,13 @@ namespace nn { namespace graphics {
 		*/
 		virtual void SetLineWidth(const f32 lineWidth);
 
+		/*!
+		@brief Gets the width of the lines to render in 2D.
+
+		@return Returns the line width in pixels.
+		*/
+		f32 GetLineWidth(void) const;
+
 		/*!
 		@brief Draws a 2D line specified in window coordinates.
 
@@ -249,6 +292,13 @@ namespace nn { namespace graphics {
 		*/
 		virtual void SetFontSize(const f32 fontSize);
 
+		/*!
+		@brief Gets the font size used when rendering text in 2D.
+
+		@return Returns the font size in pixels.
+		*/
+		f32 GetFontSize(void) const;
+
 		/*!
 		@brief Draws text at a location specified in window coordinates.
 
@@ -287,9 +337,76 @@ namespace nn { namespace graphics {
 		*/
 		virtual void Flush(void);
 
+		/*!
+		@brief Discards the primitives rendered since the last flush without drawing them.
+		*/
+		virtual void DiscardPrimitives(void);
+
+		/*!
+		@brief Shrinks the vertex arrays of triangles, quadrangles and text to the largest amount drawn so far.
+		*/
+		virtual void TrimRenderDataArrays(void);
+
+		/*!
+		@brief Sets the number of vertex buffers that triangles, quadrangles and text are uploaded to in turn.
+
+		@param[in] bufferRingNum  Specifies the number of buffers. Use the number of command lists.
+		*/
+		virtual void SetVertexBufferRingNum(const u32 bufferRingNum);
+
+		/*!
+		@brief Sets whether triangles, quadrangles and text are drawn from their vertex arrays without copying them to vertex buffers.
+
+		@param[in] directFlag  Specifies <tt>true</tt> to draw from the vertex arrays directly. Call this function before the
+		<tt>Initialize*</tt> functions of the primitives.
+		*/
+		virtual void SetDirectVertexBuffer(const bool directFlag);
+
+		/*!
+		@brief Sets whether the vertex shader converts the window coordinates of triangles, quadrangles and text.
+
+		When enabled, the vertices keep their window coordinates and the window size at the time they are flushed is applied by the
+		projection matrix. Call this function while no primitives are waiting to be flushed.
+
+		@param[in] shaderFlag  Specifies <tt>true</tt> to convert the window coordinates in the vertex shader.
+		*/
+		virtual void SetShaderWindowTransform(const bool shaderFlag);
+
+		/*!
+		@brief Sets whether the next flushes draw in ordered 2D mode.
+
+		In this mode, the primitives of each layer are drawn in the order they were rendered instead of being grouped by shader
+		program and texture, and the depth test and depth writes are disabled while they are drawn.
+
+		@param[in] orderedFlag  Specifies <tt>true</tt> to draw in ordered 2D mode.
+		*/
+		virtual void SetOrdered2dMode(const bool orderedFlag);
+
+		/*!
+		:private
+
+		@brief Sets the matrices of a shader program for the coordinates of the vertices.
+
+		@param[in] shaderProgramPtr  Specifies the shader program.
+		*/
+		void SetWindowTransform(graphics::ProgramObject* shaderProgramPtr);
+
+		/*!
+		:private
+
+		@brief Records the indices of a primitive in the draw sort queue. Call this function before packing the primitive.
+
+		@param[in] batchIndex  Specifies the batch of the primitive.
+		@param[in] firstIndex  Specifies the first index of the primitive in the render data of the batch.
+		@param[in] indicesNum  Specifies the number of indices of the primitive.
+		@return Returns <tt>false</tt> if the queue is full, in which case the primitive must be discarded.
+		*/
+		bool AddSortedPrimitive(const u32 batchIndex, const u32 firstIndex, const u32 indicesNum);
+
 	protected:
-		virtual void FlushColorFillPrimitives(void);
-		virtual void FlushTexts(void);
+		virtual void FlushSortedPrimitives(void);
+		// Empties the draw sort queue and the counters of the packed primitives.
+		void ClearSortedPrimitives(void);
 
 	public:
 		f32	 m_Color[4];
@@ -303,6 +420,7 @@ namespace nn { namespace graphics {
 
 	public:
 		graphics::ShaderManager m_ShaderManager;
+		graphics::DrawSortQueue m_DrawSortQueue;
 
 	protected:
 		bool m_InitializeTriangles;
@@ -323,8 +441,8 @@ namespace nn { namespace graphics {
 		u32 m_TotalTextLength;
 
 	protected:
-		bool m_UseColorFillProgram;
-		bool m_UseFontProgram;
+		bool m_ShaderWindowTransformFlag;
+		bool m_Ordered2dModeFlag;
 		bool m_Padding2[2];
 
 	protected:
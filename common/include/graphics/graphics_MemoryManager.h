@@ -1,10 +1,35 @@
 #ifndef GRAPHICS_MEMORY_MANAGER_H_
 #define GRAPHICS_MEMORY_MANAGER_H_
 
+#include <nn/os/os_CriticalSection.h>
+
+#include "graphics/graphics_AllocationRegistry.h"
+#include "graphics/graphics_SizeClassPool.h"
+#include "graphics/graphics_ThreadCache.h"
 #include "graphics/graphics_Utility.h"
+#include "graphics/graphics_VramAllocator.h"
 
 namespace nn { namespace graphics {
 
+	/*!
+		@brief Specifies that the memory region of a buffer is chosen by the memory manager.
+
+			   A render buffer description with this area has its color buffer and its depth-stencil buffer placed in different VRAM banks.
+	*/
+	const GLenum GRAPHICS_MEMORY_AREA_AUTO = 0;
+
+	/*!
+		@brief Defines how the memory manager places buffers requested in VRAM.
+	*/
+	enum MemoryPlacementPolicy
+	{
+		// Buffers are placed in the requested VRAM bank. The application stops when the bank is full.
+		MEMORY_PLACEMENT_POLICY_FIXED,
+		// Textures are placed in the emptier VRAM bank. A buffer that does not fit in its bank goes to the other bank, then textures
+		// and vertex buffers go to FCRAM.
+		MEMORY_PLACEMENT_POLICY_BALANCED
+	};
+
 	namespace detail {
 		/*!
 			@brief Manages memory regions allocated for graphics.
@@ -34,8 +59,9 @@ namespace nn { namespace graphics {
 
 				@param[in] fcramAddress  Specifies the start address of the memory region in FCRAM used for graphics.
 				@param[in] memorySize  Specifies the size of the memory region used for graphics.
+				@param[in] threadSafe  Specifies whether other threads than the calling one allocate and free memory.
 			*/
-			void Initialize(const uptr fcramAddress, const size_t memorySize);
+			void Initialize(const uptr fcramAddress, const size_t memorySize, const bool threadSafe = false);
 
 			/*!
 				@brief Finalizes the memory manager class instance.
@@ -57,7 +83,7 @@ namespace nn { namespace graphics {
 			/*!
 				@brief Frees the memory region allocated by this class.
 
-						  Note that the region is not freed if <tt>area</tt> specifies VRAM.
+						  A region in VRAM is returned to the allocator of its bank and merged with the adjacent free regions.
 
 				@param[in] area  Specifies the memory region that contains the buffer to free.
 				@param[in] aim  Specifies the purpose of the buffer to free.
@@ -66,19 +92,108 @@ namespace nn { namespace graphics {
 			*/
 			void Deallocate(GLenum area, GLenum aim, GLuint id, void* addr);
 
+			/*!
+				@brief Allocates a buffer from the heap in main memory.
+
+						  Buffers of up to <tt>SIZE_CLASS_POOL_MAX_CLASS_SIZE</tt> bytes come from the size class pool, and from the cache of
+						  the calling thread in thread-safe mode. Larger buffers, and buffers of a full size class, come from the heap.
+
+				@param[in] size  Specifies the size of the buffer to allocate.
+
+				@return Returns the address of the allocated buffer.
+			*/
+			void* Alloc(size_t size);
+
+			/*!
+				@brief Frees a buffer allocated by <tt>Alloc</tt>.
+
+				@param[in] ptr  Specifies the address of the buffer to free.
+			*/
+			void Free(void* ptr);
+
+			/*!
+				@brief Gives the calling thread its own cache of small buffers. This is only valid in thread-safe mode.
+
+				@return Returns <tt>false</tt> if the mode is not thread-safe or all caches are used.
+			*/
+			bool RegisterThread(void);
+
+			/*!
+				@brief Returns the buffers in the cache of the calling thread to the heap and releases the cache.
+			*/
+			void UnregisterThread(void);
+
 			/*!
 				@brief Sends the current free space and maximum space of main memory and VRAM to debug output.
 			*/
 			void PrintFreeMemorySize(void);
 
+			// Gets the live memory of each memory region and purpose.
+			void GetSnapshot(MemorySnapshot& snapshot) const;
+			// Sends the live blocks to debug output. See <tt>PrintMemoryLiveBlocks</tt>.
+			void PrintLiveBlocks(const u32 maxNum, const MemoryBlockSortKey sortKey, const MemorySnapshot* pSince) const;
+
+			/*!
+				@brief Gets the allocator of a VRAM bank.
+
+				@param[in] area  Specifies the VRAM bank (<tt>NN_GX_MEM_VRAMA</tt> or <tt>NN_GX_MEM_VRAMB</tt>).
+
+				@return Returns the allocator of the bank.
+			*/
+			const VramAllocator& GetVramAllocator(GLenum area) const;
+
+			/*!
+				@brief Gets the VRAM bank with the most free space.
+
+				@return Returns <tt>NN_GX_MEM_VRAMA</tt> or <tt>NN_GX_MEM_VRAMB</tt>.
+			*/
+			GLenum GetEmptierVramArea(void) const;
+
+			void				  SetPlacementPolicy(const MemoryPlacementPolicy policy);
+			MemoryPlacementPolicy GetPlacementPolicy(void) const;
+
+		protected:
+			/*!
+				@brief Chooses the memory region of a buffer according to the placement policy.
+
+				@param[in] area  Specifies the memory region requested.
+				@param[in] aim  Specifies the purpose of the buffer.
+				@param[in] size  Specifies the size of the buffer.
+				@param[in] addrAlign  Specifies the alignment of the buffer.
+
+				@return Returns the memory region in which to allocate the buffer.
+			*/
+			GLenum SelectArea(GLenum area, GLenum aim, GLsizei size, const u32 addrAlign) const;
+
+			// These functions must be called with the critical section entered in thread-safe mode.
+			void*		 AllocateImpl(GLenum area, GLenum aim, GLuint id, GLsizei size);
+			void		 DeallocateImpl(GLenum area, GLenum aim, GLuint id, void* addr);
+			void		 RefillThreadCache(ThreadCache* pThreadCache, const u32 classIndex);
+			void		 FlushThreadCache(ThreadCache* pThreadCache, const u32 classIndex, const u32 blockNum);
+			ThreadCache* FindThreadCache(void);
+			// Adds the blocks of the size-class pool in use by the application to the system buffers in FCRAM.
+			void		 AddPooledBlocks(MemorySnapshot& snapshot) const;
+
 		private:
 			bool			 m_Initialized;
 			u8				 m_Pad[3];
 			uptr			 m_pStartAddrFcram;
-			uptr			 m_CurrentAddrVramA;
-			uptr			 m_CurrentAddrVramB;
+			VramAllocator	 m_VramAllocatorA;
+			VramAllocator	 m_VramAllocatorB;
 			nn::fnd::ExpHeap m_HeapOnFcram;
 			size_t			 m_AllocatedBlockSize;
+			SizeClassPool	 m_SizeClassPool;
+			void*			 m_pSizeClassPoolRegion;
+
+			AllocationRegistry m_AllocationRegistry;
+
+			MemoryPlacementPolicy m_PlacementPolicy;
+			u32					  m_FcramFallbackNum;
+
+			bool							m_ThreadSafeFlag;
+			u8								m_Padding[3];
+			mutable nn::os::CriticalSection m_CriticalSection;
+			ThreadCache						m_ThreadCacheArray[GRAPHICS_THREAD_CACHE_MAX_NUM];
 		};
 	}  // namespace detail
 
@@ -87,8 +202,25 @@ namespace nn { namespace graphics {
 
 		@param[in] fcramAddress  Specifies the start address of the memory region in FCRAM used for graphics.
 		@param[in] memorySize  Specifies the size of the memory region used for graphics.
+		@param[in] threadSafe  Specifies whether other threads than the calling one allocate and free memory.
+	*/
+	void InitializeMemoryManager(const uptr fcramAddress, const size_t memorySize, const bool threadSafe = false);
+
+	/*!
+		@brief Gives the calling thread its own cache of small buffers allocated by <tt>Alloc</tt>.
+
+			   This is only valid when the memory manager is thread-safe. The thread that initializes the memory manager is
+			   registered automatically. Call <tt>UnregisterMemoryManagerThread</tt> before the thread exits.
+
+		@return Returns <tt>false</tt> if the memory manager is not thread-safe or <tt>GRAPHICS_THREAD_CACHE_MAX_NUM</tt> threads
+				are already registered.
+	*/
+	bool RegisterMemoryManagerThread(void);
+
+	/*!
+		@brief Returns the cached buffers of the calling thread to the memory manager.
 	*/
-	void InitializeMemoryManager(const uptr fcramAddress, const size_t memorySize);
+	void UnregisterMemoryManagerThread(void);
 
 	/*!
 		@brief Finalizes the memory manager.
@@ -100,6 +232,55 @@ namespace nn { namespace graphics {
 	*/
 	void PrintMemoryManagerInfo(void);
 
+	/*!
+		@brief Gets the allocator of a VRAM bank managed by the memory manager.
+
+		@param[in] area  Specifies the VRAM bank (<tt>NN_GX_MEM_VRAMA</tt> or <tt>NN_GX_MEM_VRAMB</tt>).
+
+		@return Returns the allocator of the bank.
+	*/
+	const detail::VramAllocator& GetVramAllocator(GLenum area);
+
+	/*!
+		@brief Gets the VRAM bank with the most free space.
+
+		@return Returns <tt>NN_GX_MEM_VRAMA</tt> or <tt>NN_GX_MEM_VRAMB</tt>.
+	*/
+	GLenum GetEmptierVramArea(void);
+
+	/*!
+		@brief Sets how the memory manager places buffers requested in VRAM.
+
+			   The default is <tt>MEMORY_PLACEMENT_POLICY_BALANCED</tt>.
+
+		@param[in] policy  Specifies the placement policy.
+	*/
+	void SetMemoryPlacementPolicy(const MemoryPlacementPolicy policy);
+
+	/*!
+		@brief Gets the live memory of each memory region and purpose.
+
+			   Compare two snapshots with <tt>MemorySnapshot::PrintDifference</tt> to check that the memory usage is flat. Blocks
+			   from the size-class pool count as system buffers in FCRAM.
+
+		@param[out] snapshot  Receives the live memory.
+	*/
+	void GetMemorySnapshot(MemorySnapshot& snapshot);
+
+	/*!
+		@brief Sends the live blocks with their memory region, purpose and GL ID to debug output.
+
+			   Blocks of 4 KB or less from <tt>Alloc</tt> come from the size-class pool and are not listed one by one. Their number
+			   and size are printed per size class instead.
+
+		@param[in] maxNum  Specifies the maximum number of blocks to print.
+		@param[in] sortKey  Specifies the order of the blocks.
+		@param[in] pSince  Specifies a snapshot; only the blocks allocated after it and still live are printed. <tt>NULL</tt> prints all blocks.
+	*/
+	void PrintMemoryLiveBlocks(const u32			   maxNum,
+							   const MemoryBlockSortKey sortKey = MEMORY_BLOCK_SORT_KEY_SIZE,
+							   const MemorySnapshot*	pSince	= NULL);
+
 	/*!
 		@brief Gets the memory allocator specified as an argument to the <tt>nngxInitialize</tt> function
 
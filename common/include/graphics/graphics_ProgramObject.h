@@ -5,6 +5,7 @@
 #include <nn/math.h>
 
 #include "graphics/graphics_TrianglesRenderData.h"
+#include "graphics/graphics_UniformLocationTable.h"
 #include "graphics/graphics_Utility.h"
 
 namespace nn { namespace graphics {
@@ -19,6 +20,36 @@ namespace nn { namespace graphics {
 	/*!
 	:private
 
+	@brief Specifies the number of matrix uniforms whose values the <tt>ProgramObject</tt> class caches: the projection and model view
+	matrices.
+	*/
+	const u32 PROGRAM_OBJECT_MATRIX_UNIFORMS_NUM = 2;
+
+	/*!
+	:private
+
+	@brief Specifies the size of the command list that holds the saved state commands of a shader program object.
+	*/
+	const u32 PROGRAM_STATE_COMMAND_LIST_SIZE = 0x1000;
+
+	/*!
+	:private
+
+	@brief Specifies the number of requests of the command list that holds the saved state commands of a shader program object.
+	*/
+	const u32 PROGRAM_STATE_COMMAND_REQUEST_NUM = 4;
+
+	/*!
+	:private
+
+	@brief Specifies the driver states whose commands are saved for a shader program object.
+	*/
+	const GLbitfield PROGRAM_STATE_COMMAND_STATE_MASK = NN_GX_STATE_SHADERPROGRAM | NN_GX_STATE_SHADERMODE | NN_GX_STATE_SHADERFLOAT |
+														NN_GX_STATE_VSUNIFORM | NN_GX_STATE_FSUNIFORM;
+
+	/*!
+	:private
+
 	@brief Represents the base class for shader programs.
 	*/
 
@@ -89,6 +120,24 @@ namespace nn { namespace graphics {
 		/*!
 		:private
 
+		@brief Gets the handle of the program object.
+
+		@return Returns the program object handle.
+		*/
+		GLuint GetProgramId(void) const;
+
+		/*!
+		:private
+
+		@brief Gets whether the shader program object is initialized.
+
+		@return Returns <tt>true</tt> if it is initialized.
+		*/
+		bool IsInitialized(void) const;
+
+		/*!
+		:private
+
 		@brief Sets whether to convert the three-dimensional vertex position coordinates to clip coordinates using the projection matrix and
 		model view matrix.
 
@@ -130,25 +179,92 @@ namespace nn { namespace graphics {
 		*/
 		virtual void Update(void);
 
+	public:
+		/*!
+		:private
+
+		@brief Sets the table of uniform locations shared by the programs of the same shader binary. Call this function before
+		<tt>Initialize</tt>. A program whose uniform locations differ from the table uses a table of its own.
+
+		@param[in] pUniformLocationTable  Specifies the uniform location table.
+		*/
+		void SetUniformLocationTable(UniformLocationTable* pUniformLocationTable);
+
+	public:
+		/*!
+		:private
+
+		@brief Sets the state that the shader program object always uses: its matrices for 2D rendering and its fragment uniforms.
+		*/
+		virtual void SetupState(void);
+
+		/*!
+		:private
+
+		@brief Saves the commands that <tt>SetupState</tt> generates, so that <tt>Use</tt> adds them instead of calling it. Call this
+		function after <tt>Initialize</tt>.
+
+		@return Returns <tt>false</tt> if the shader program object is not initialized or the commands are already saved.
+		*/
+		bool SaveStateCommand(void);
+
+		/*!
+		:private
+
+		@brief Deletes the commands saved by <tt>SaveStateCommand</tt>.
+		*/
+		void FinalizeStateCommand(void);
+
+	protected:
+		// Uses the program and sets its state, by adding the saved commands when they can be used.
+		void UseState(void);
+
 	protected:
 		virtual void InitializeVertexAttributes(void);
 		virtual void InitializeUniforms(void);
 		virtual void UpdateModelViewProjectionMatrix(void);
 
+	protected:
+		// Uniforms are state of the program object, so a call that sets the value the uniform already has is skipped.
+		void SetUniform1i(const u32 uniformIndex, const GLint value);
+		void SetUniform3i(const u32 uniformIndex, const GLint value0, const GLint value1, const GLint value2);
+		void SetUniform4fv(const u32 uniformIndex, const GLfloat* pValues);
+		// <tt>uniformIndex</tt> must be <tt>PROGRAM_UNIFORM_PROJECTION</tt> or <tt>PROGRAM_UNIFORM_MODELVIEW</tt>.
+		void SetUniformMatrix4fv(const u32 uniformIndex, const GLfloat* pMatrix);
+		bool UpdateUniformCache(const u32 uniformIndex, const bit32* pValues, const u32 valuesNum);
+		GLint GetUniformLocation(const u32 uniformIndex) const;
+		void ResetUniformCache(void);
+
 	protected:
 		bool m_Initialized;
 		bool m_Padding0[3];
 
 		u32	 m_VertexAttributes;
 		bool m_Use3d;
-		u8	 m_Padding[3];
+		// Whether the matrix uniforms of the program hold the identity matrices used in 2D.
+		bool m_Matrix2dFlag;
+		u8	 m_Padding[2];
 
 		GLuint m_ProgramId;
 		GLuint m_ShaderIds[PROGRAM_OBJECT_MAX_SHADERS];
-		GLint  m_UniformLocation[MAX_UNIFORM_LOCATIONS_NUM];
+
+		UniformLocationTable*	m_pUniformLocationTable;
+		// The table the uniforms are set with: the shared one, or the one of the program when its locations differ.
+		UniformLocationTable*	m_pCurrentUniformLocationTable;
+		UniformLocationTable	m_ProgramUniformLocationTable;
+
+		bool	m_UniformCachedArray[PROGRAM_UNIFORMS_NUM];
+		bit32	m_UniformValueArray[PROGRAM_UNIFORMS_NUM][4];
+		GLfloat m_UniformMatrixArray[PROGRAM_OBJECT_MATRIX_UNIFORMS_NUM][16];
 
 		nn::math::MTX44 m_ProjectionMatrix;
 		nn::math::MTX44 m_ModelViewMatrix;
+
+		// Command list that holds the saved state commands, and their range in it.
+		GLuint	m_StateCommandListId;
+		GLuint	m_StateCommandBufferOffset;
+		GLsizei m_StateCommandBufferSize;
+		GLuint	m_StateCommandRequestId;
 	};
 
 }}	// namespace nn::graphics
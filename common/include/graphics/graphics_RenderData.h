@@ -2,6 +2,7 @@
 #define GRAPHICS_RENDER_DATA_H_
 
 #include <nn/gx.h>
+#include <nn/math.h>
 #include <nn/util.h>
 
 namespace nn { namespace graphics {
@@ -29,6 +30,17 @@ namespace nn { namespace graphics {
 	/*!
 	:private
 
+	@brief Gets the projection matrix that converts window coordinates to normalized device coordinates, rotating them to the LCD.
+
+	@param[in]    windowWidth       Specifies the window width.
+	@param[in]    windowHeight      Specifies the window height.
+	@param[out]   projectionMatrix  Specifies the matrix to get.
+	*/
+	void GetWindowProjectionMatrix(const f32 windowWidth, const f32 windowHeight, nn::math::MTX44& projectionMatrix);
+
+	/*!
+	:private
+
 	@brief Base class for the rendering data.
 	*/
 	class RenderData : private nn::util::NonCopyable<RenderData>
@@ -81,12 +93,23 @@ namespace nn { namespace graphics {
 		*/
 		virtual void SetWindowSize(const f32 windowWidth, const f32 windowHeight);
 
+		/*!
+		:private
+
+		@brief Sets whether the vertex positions are left in window coordinates for the vertex shader to convert.
+
+		@param[in] shaderFlag  Specifies <tt>true</tt> to leave the vertex positions in window coordinates.
+		*/
+		void SetShaderWindowTransform(const bool shaderFlag);
+
 	public:
 		/*!
 		:private
 
 		@brief Converts the specified window coordinates to normalized device coordinates.
 
+		When the vertex shader converts the window coordinates, they are returned as they are.
+
 		@param[in] windowCoordinateX  Specifies the x-coordinate for the window coordinates.
 		@param[in] windowCoordinateY  Specifies the y-coordinate for the window coordinates.
 		@param[out] normalizedDeviceCoordinateX  Specifies the x-coordinate for the normalized device coordinates.
@@ -127,6 +150,9 @@ namespace nn { namespace graphics {
 
 		f32 m_InverseWindowWidth;
 		f32 m_InverseWindowHeight;
+
+		bool m_ShaderWindowTransformFlag;
+		u8	 m_Padding0[3];
 	};
 
 }}	// namespace nn::graphics
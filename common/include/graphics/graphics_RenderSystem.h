@@ -8,7 +8,10 @@
 
 #include "graphics/graphics_CommandList.h"
 #include "graphics/graphics_DisplayBuffers.h"
+#include "graphics/graphics_DrawStatistics.h"
+#include "graphics/graphics_FrameArena.h"
 #include "graphics/graphics_FrameBuffer.h"
+#include "graphics/graphics_FrameProfiler.h"
 
 #include "graphics/graphics_ShaderManager.h"
 
@@ -71,13 +74,78 @@ namespace nn { namespace graphics {
 		virtual void SetSerialRun(const bool flag);
 		virtual void CheckRenderTarget(void);
 
+	public:
+		/*!
+		@brief Sets the number of command lists in flight. Call before <tt>Initialize</tt>.
+
+		When 2, <tt>SwapBuffers</tt> returns as soon as the frame has been run and the next frame is built while the GPU
+		executes it. The display buffer swap is issued after the GPU has finished the frame, and each display gets at least
+		three display buffers. More command lists would not overlap more work, because a frame is only run once the GPU has
+		finished the previous one.
+
+		@param[in] commandListNum Number of command lists, 1 to <tt>GRAPHICS_COMMAND_LIST_NUM</tt> (2). The default is 1.
+		*/
+		virtual void SetCommandListNum(const u32 commandListNum);
+		/*!
+		@brief Sets the size of each buffer of the frame arena used by <tt>AllocFrame</tt>. Call before <tt>Initialize</tt>.
+
+		The frame arena has one buffer per command list. The library does not use it itself, so the default is
+		<tt>GRAPHICS_FRAME_ARENA_DEFAULT_BUFFER_SIZE</tt> (0) and no buffer is allocated until a size is set.
+
+		@param[in] bufferSize Size of each buffer in bytes. Specify 0 to not allocate the frame arena.
+		*/
+		virtual void SetFrameArenaSize(const size_t bufferSize);
+		/*!
+		@brief Makes the memory manager thread-safe. Call before <tt>Initialize</tt>.
+
+		Other threads, such as an asset loading thread, can then allocate textures and buffers while this thread renders.
+		Each of them should call <tt>RegisterMemoryManagerThread</tt> to allocate small buffers without locking.
+
+		@param[in] flag Specifies whether the memory manager is thread-safe. The default is <tt>false</tt>.
+		*/
+		virtual void SetThreadSafeAllocator(const bool flag);
+		/*!
+		@brief Sets whether a display only shows 2D drawing, such as the lower LCD.
+
+		In ordered 2D mode, the 2D primitives of each layer are drawn in the order they were rendered, without the depth test and
+		without writing the depth buffer, so their depth values do not matter. <tt>Clear</tt> then only clears the color buffer.
+
+		@param[in] display Specifies <tt>NN_GX_DISPLAY0</tt>, <tt>NN_GX_DISPLAY1</tt> or <tt>NN_GX_DISPLAY_BOTH</tt>.
+		@param[in] flag Specifies whether the display uses ordered 2D mode. The default is <tt>false</tt>.
+		*/
+		virtual void SetOrdered2dMode(const s32 display, const bool flag);
+		// Returns <tt>true</tt> if the display uses ordered 2D mode.
+		bool IsOrdered2dMode(const GLenum display) const;
+		// Gets the command list for usage statistics and storage settings.
+		CommandList& GetCommandList(void);
+		// Gets the frame profiler. Measuring starts when it is enabled with <tt>FrameProfiler::SetEnabled</tt>.
+		FrameProfiler& GetFrameProfiler(void);
+		// Gets the drawing counters of the last frame completed by <tt>SwapBuffers</tt>.
+		const DrawStatistics& GetDrawStatistics(void) const;
+
+	protected:
+		// Issue the display buffer swap of the frame that the GPU has finished.
+		virtual void SwapPendingDisplayBuffers(void);
+		// End a frame that drew nothing, so that the target display keeps showing its last frame. The command list still runs and
+		// the display is still swapped.
+		virtual void SkipSwapBuffers(void);
+
 	protected:
 		bool m_InitializeFlag;
 		bool m_InitializeLcdDisplayFlag;
-		bool m_Padding[2];
+		bool m_ThreadSafeAllocatorFlag;
+		bool m_Padding[1];
+		// Ordered 2D mode of the upper and lower displays.
+		bool m_Ordered2dModeFlagArray[2];
+		bool m_Padding1[2];
 
 		GLenum m_TargetDisplay;
 
+		u32	   m_CommandListNum;
+		size_t m_FrameArenaSize;
+		GLenum m_PendingSwapDisplay;
+		GLuint m_PendingSwapDisplayBufferId;
+
 		DisplayBuffers* m_CurrentDisplayBuffersPtr;
 		FrameBuffer*	m_CurrentFrameBufferPtr;
 
@@ -86,7 +154,8 @@ namespace nn { namespace graphics {
 
 		DisplayBuffers m_DisplayBuffers1;
 
-		CommandList m_CommandList;
+		CommandList	  m_CommandList;
+		FrameProfiler m_FrameProfiler;
 	};
 
 }}	// namespace nn::graphics
@@ -1,6 +1,7 @@
 ﻿#ifndef GRAPHICS_RENDER_SYSTEM_DRAWING_H_
 #define GRAPHICS_RENDER_SYSTEM_DRAWING_H_
 
+#include "graphics/graphics_DirtyRegion.h"
 #include "graphics/graphics_GraphicsDrawing.h"
 #include "graphics/graphics_RenderSystem.h"
 #include "graphics/graphics_Utility.h"
@@ -105,6 +106,47 @@ namespace nn { namespace graphics {
 		*/
 		void InitializeTexturedTriangles(const u32 maxTrianglesNum = MAX_TEXTURED_TRIANGLES_NUM);
 
+		/*!
+		@brief  Releases the unused part of the vertex arrays of 2D primitives.
+
+				  The vertex arrays start small and grow as primitives are drawn, up to the maximum numbers given to the
+		<tt>Initialize*</tt> functions. Call this function once the application has drawn its typical frames to shrink each array to the
+		largest amount drawn so far. The arrays grow again if more primitives are drawn later.
+		*/
+		void TrimRenderDataArrays(void);
+
+		/*!
+		@brief  Sets whether 2D primitives are written directly into the memory that the GPU draws from.
+
+				  When enabled, the GPU reads the vertex arrays of 2D primitives as they are, so nothing is copied to vertex buffers when
+		they are drawn. Each command list gets its own arrays, which uses more memory. Call this function before the <tt>Initialize</tt>
+		function. (The default is <tt>false</tt>.)
+
+		@param[in]   directFlag      Specifies <tt>true</tt> to draw 2D primitives from their vertex arrays directly.
+		*/
+		void SetDirectVertexBuffer(const bool directFlag);
+
+		/*!
+		@brief  Sets whether the vertex shader converts the window coordinates of 2D primitives to normalized device coordinates.
+
+				  When enabled, the vertices of 2D primitives keep their window coordinates and the CPU does not convert them. The window
+		size set by <tt>SetViewport</tt> is applied when the primitives are flushed. Call this function before the <tt>Initialize</tt>
+		function. (The default is <tt>false</tt>.)
+
+		@param[in]   shaderFlag      Specifies <tt>true</tt> to convert the window coordinates in the vertex shader.
+		*/
+		void SetShaderWindowTransform(const bool shaderFlag);
+
+		/*!
+		@brief  Gets the shader manager used to draw 2D primitives.
+
+				  Use it to load additional shader binaries and to register shader programs under IDs, at any time after the
+		<tt>Initialize</tt> function.
+
+		@return      Returns the shader manager.
+		*/
+		graphics::ShaderManager& GetShaderManager(void);
+
 		virtual void Finalize(void);
 
 		virtual void SetViewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
@@ -113,6 +155,47 @@ namespace nn { namespace graphics {
 
 		virtual void Clear(const GLbitfield mask = (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
 
+	public:
+		/*!
+		@brief Sets whether <tt>SwapBuffers</tt> only redraws the part of a display that changed since its previous frame.
+
+		The clear and the 2D primitives of each frame are compared with those of the previous frame of the display. Only the
+		rectangle covering the tiles where they differ is cleared and drawn, with the scissor test, and when nothing differs the
+		frame is neither drawn, transferred nor swapped, so the display keeps showing its last frame. The display is drawn in
+		ordered 2D mode, and <tt>Clear</tt> fills the color buffer with the clear color as the first primitive of layer 0.
+
+		Only the 2D drawing functions of this class are compared, so do not draw to the display with the GL directly. The upper
+		and lower LCD share the frame buffer, so the whole display is redrawn when the other one was drawn since its last frame.
+
+		@param[in] display Specifies <tt>NN_GX_DISPLAY0</tt>, <tt>NN_GX_DISPLAY1</tt> or <tt>NN_GX_DISPLAY_BOTH</tt>.
+		@param[in] flag Specifies whether the display is redrawn by dirty region. The default is <tt>false</tt>.
+		*/
+		virtual void SetDirtyRegionMode(const s32 display, const bool flag);
+
+		// Returns <tt>true</tt> if the display is redrawn by dirty region.
+		bool IsDirtyRegionMode(const GLenum display) const;
+
+		/*!
+		@brief Redraws the whole display at its next frame in dirty region mode.
+
+		Call this function when the display changed in a way that is not compared, such as the image of a texture being replaced
+		or an applet using the LCD.
+
+		@param[in] display Specifies <tt>NN_GX_DISPLAY0</tt>, <tt>NN_GX_DISPLAY1</tt> or <tt>NN_GX_DISPLAY_BOTH</tt>.
+		*/
+		virtual void InvalidateDirtyRegion(const s32 display);
+
+	protected:
+		graphics::DirtyRegion& GetDirtyRegion(const GLenum display);
+		// Records a 2D primitive in the dirty region of the target display, within the bounding box of its vertices widened by
+		// the margin. The data are everything but the color, layer and vertices that decides its pixels.
+		void AddDirtyPrimitive(const u32	primitiveType,
+							   const f32*	windowCoordinateArray,
+							   const u32	verticesNum,
+							   const f32	margin,
+							   const void*	pData,
+							   const size_t dataSize);
+
 	public:
 		/*!
 		@brief Sets the vertex color of a primitive to render in 2D.
@@ -147,6 +230,17 @@ namespace nn { namespace graphics {
 		*/
 		virtual void SetAutoDepth(const bool enableAutoDepth);
 
+		/*!
+		@brief Sets the layer of the primitives rendered in 2D from now on.
+
+		The layers are drawn in ascending order, whatever the depth of their primitives. In a layer, textured triangles are drawn
+		first, then triangles and quadrangles, then text. Text is blended, so it is drawn in the order it was rendered. The layer is
+		reset to 0 after each flush.
+
+		@param[in] layer  Specifies the layer ([0,<tt>MAX_DRAW_SORT_LAYER_NUM</tt>)).
+		*/
+		virtual void SetLayer(const u32 layer);
+
 	public:
 		/*!
 		@brief Sets the size when drawing a point in 2D.
@@ -293,6 +387,16 @@ namespace nn { namespace graphics {
 		*/
 		virtual void DrawText(const f32 windowCoordinateX, const f32 windowCoordinateY, const char* format, ...);
 
+		/*!
+		@brief  Draws the average, maximum and 99th percentile time of each frame phase measured by the frame profiler.
+
+		The text uses the current color and font size and takes <tt>FRAME_PROFILER_PHASE_NUM + 1</tt> lines.
+
+		@param[in] windowCoordinateX  Specifies the x-coordinate of the top-left of the text in the window coordinate system.
+		@param[in] windowCoordinateY  Specifies the y-coordinate of the top-left of the text in the window coordinate system.
+		*/
+		virtual void DrawFrameProfiler(const f32 windowCoordinateX, const f32 windowCoordinateY);
+
 	public:
 		/*!
 		@brief  Checks whether the handle for the texture object is valid.
@@ -418,15 +522,15 @@ namespace nn { namespace graphics {
 
 	protected:
 		virtual void Flush(void);
-		virtual void FlushTexturedPrimitives(void);
 
 	protected:
 		GraphicsDrawing m_GraphicsDrawing;
 
 	protected:
 		bool m_InitializeTexturedTriangles;
-		bool m_UseDecalTextureProgram;
-		bool m_Padding[2];
+		bool m_DirectVertexBufferFlag;
+		bool m_ShaderWindowTransformFlag;
+		bool m_Padding[1];
 
 		u32	   m_MaxTexturedTrianglesNum;
 		GLuint m_TextureIdArray[nn::graphics::MAX_TEXTURES_NUM];
@@ -435,6 +539,13 @@ namespace nn { namespace graphics {
 		nn::graphics::TrianglesRenderData m_TexturedTrianglesRenderDataArray[nn::graphics::MAX_TEXTURES_NUM];
 
 		f32 m_ClearColorArray[3][4];
+
+		// Dirty region mode of the upper and lower displays.
+		bool m_DirtyRegionModeFlagArray[2];
+		bool m_Padding1[2];
+		// The display whose last frame is in the frame buffer.
+		GLenum				  m_FrameBufferDisplay;
+		graphics::DirtyRegion m_DirtyRegionArray[2];
 	};
 
 }}	// namespace nn::graphics
@@ -14,16 +14,24 @@ namespace nn { namespace graphics {
 	/*!
 	:private
 
-	@brief Specifies the maximum number of shader binaries in the <tt>ShaderManager</tt> class.
+	@brief Specifies the maximum number of shader binaries in the <tt>ShaderManager</tt> class, including the basic shader binary.
 	*/
-	const u32 MAX_SHADER_BINARY_NUM = 1;
+	const u32 MAX_SHADER_BINARY_NUM = 4;
 
 	/*!
 	:private
 
 	@brief Specifies the maximum number of shaders per shader binary in the <tt>ShaderManager</tt> class.
 	*/
-	const u32 MAX_SHADER_PROGRAM_NUM = 3;
+	const u32 MAX_SHADER_PROGRAM_NUM = 8;
+
+	/*!
+	:private
+
+	@brief Specifies the number of IDs under which the <tt>ShaderManager</tt> class can register shader programs. The IDs below
+	<tt>BASIC_SHADER_BINARY_SHADER_NUM</tt> are used by the basic shaders.
+	*/
+	const u32 MAX_SHADER_PROGRAM_REGISTRY_NUM = 16;
 
 	/*!
 	:private
@@ -83,34 +91,98 @@ namespace nn { namespace graphics {
 		*/
 		virtual bool Finalize(void);
 
+	public:
+		/*!
+		:private
+
+		@brief Loads a shader binary from memory.
+
+		@param[in] pShaderBinary       Specifies the shader binary. It is only read during the call.
+		@param[in] shaderBinarySize    Specifies the size of the shader binary in bytes.
+		@param[in] shaderNum           Specifies the number of vertex shaders in the shader binary.
+		@param[out] shaderBinaryIndex  Gets the index of the loaded shader binary.
+		@return Returns <tt>false</tt> if there is no room for the shader binary or if it cannot be loaded.
+		*/
+		bool LoadShaderBinary(const void* pShaderBinary, const s32 shaderBinarySize, const u32 shaderNum, u32& shaderBinaryIndex);
+
+		/*!
+		:private
+
+		@brief Unloads a shader binary loaded by <tt>LoadShaderBinary</tt>. Unregister its shader programs first.
+
+		@param[in] shaderBinaryIndex  Specifies the index of the shader binary.
+		@return Returns <tt>false</tt> if the shader binary is not loaded or a shader program still uses it.
+		*/
+		bool UnloadShaderBinary(const u32 shaderBinaryIndex);
+
+		/*!
+		:private
+
+		@brief Registers a shader program under an ID, with a vertex shader of a loaded shader binary, and initializes it. The basic
+		shaders are initialized by the first <tt>GetShaderProgram</tt> for their ID instead.
+
+		The shader programs of a shader binary share the locations of the uniforms in <tt>ProgramUniform</tt>. A program whose vertex
+		shader binds those uniforms to other registers looks them up again and keeps its own locations.
+
+		@param[in] programId          Specifies the ID. Use an ID from <tt>BASIC_SHADER_BINARY_SHADER_NUM</tt> up to
+		<tt>MAX_SHADER_PROGRAM_REGISTRY_NUM</tt>.
+		@param[in] programObjectPtr   Specifies the shader program. It must stay valid until it is unregistered.
+		@param[in] shaderBinaryIndex  Specifies the index of the shader binary.
+		@param[in] shaderIndex        Specifies the index of the vertex shader in the shader binary.
+		@return Returns <tt>false</tt> if the ID is in use, the shader program is already initialized or it cannot be initialized. The
+		shader program is not registered then.
+		*/
+		bool RegisterShaderProgram(const u32	  programId,
+								   ProgramObject* programObjectPtr,
+								   const u32	  shaderBinaryIndex,
+								   const u32	  shaderIndex);
+
+		/*!
+		:private
+
+		@brief Finalizes a shader program registered by <tt>RegisterShaderProgram</tt> and removes it from the registry.
+
+		@param[in] programId  Specifies the ID of the shader program.
+		@return Returns <tt>false</tt> if no shader program is registered under the ID or it is a basic shader.
+		*/
+		bool UnregisterShaderProgram(const u32 programId);
+
 	protected:
 		virtual bool InitializeBasicShader(void);
+		ProgramObject* GetRegisteredShaderProgram(const u32 programId);
 
 	public:
 		/*!
 		:private
 
 		@brief Gets the vertex attributes of the specified shader.
-		@param[in] shaderType  Specifies the shader type.
+		@param[in] programId  Specifies the shader type or the ID of a registered shader program.
 		@return Returns vertex attributes.
 		*/
-		u32 GetVertexAttributes(const ShaderType shaderType);
+		u32 GetVertexAttributes(const u32 programId);
 
 		/*!
 		:private
 
-		@brief Gets a pointer to the specified shader.
+		@brief Gets a pointer to the specified shader. A basic shader is initialized the first time it is got.
 
-		@param[in] shaderType  Specifies the shader type.
+		@param[in] programId  Specifies the shader type or the ID of a registered shader program.
 		@return Returns a pointer to the shader program.
 		*/
-		ProgramObject* GetShaderProgram(const ShaderType shaderType);
+		ProgramObject* GetShaderProgram(const u32 programId);
 
 	protected:
 		bool		   m_Initialized;
 		u8			   m_Padding[3];
-		GLuint		   m_ShaderProgramIdArray[MAX_SHADER_BINARY_NUM][MAX_SHADER_PROGRAM_NUM];
-		ProgramObject* m_ShaderProgramPtrArray[MAX_SHADER_BINARY_NUM][MAX_SHADER_PROGRAM_NUM];
+		// Vertex shaders of each shader binary. A shader binary is loaded when its number of shaders is not 0.
+		GLuint m_ShaderIdArray[MAX_SHADER_BINARY_NUM][MAX_SHADER_PROGRAM_NUM];
+		u32	   m_ShaderNumArray[MAX_SHADER_BINARY_NUM];
+		// Registered shader programs by ID, with the index of the shader binary of each one.
+		ProgramObject* m_ShaderProgramPtrArray[MAX_SHADER_PROGRAM_REGISTRY_NUM];
+		u32			   m_ShaderBinaryIndexArray[MAX_SHADER_PROGRAM_REGISTRY_NUM];
+		u32			   m_ShaderIndexArray[MAX_SHADER_PROGRAM_REGISTRY_NUM];
+		// The programs of a shader binary share the locations of their uniforms.
+		UniformLocationTable m_UniformLocationTableArray[MAX_SHADER_BINARY_NUM];
 
 	protected:
 		ColorFillProgram	m_ColorFillProgram;
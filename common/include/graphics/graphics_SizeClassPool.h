@@ -0,0 +1,76 @@
+#ifndef GRAPHICS_SIZE_CLASS_POOL_H_
+#define GRAPHICS_SIZE_CLASS_POOL_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	namespace detail {
+		// Size classes of the pool: 64, 128, 256, 512, 1024, 2048 and 4096 bytes.
+		const u32 SIZE_CLASS_POOL_CLASS_NUM			  = 7;
+		const u32 SIZE_CLASS_POOL_MIN_CLASS_SIZE_LOG2 = 6;
+		const u32 SIZE_CLASS_POOL_MAX_CLASS_SIZE	  = (1 << (SIZE_CLASS_POOL_MIN_CLASS_SIZE_LOG2 + SIZE_CLASS_POOL_CLASS_NUM - 1));
+
+		/*!
+			@brief Allocates small buffers of fixed size classes from one region.
+
+				   Each size class has its own slab of blocks, so the class of a block is found from its address and blocks need
+				   no header. Free blocks are linked through their own first word; allocation and deallocation are O(1).
+		*/
+		class SizeClassPool : private nn::util::NonCopyable<SizeClassPool>
+		{
+		public:
+			SizeClassPool(void);
+			virtual ~SizeClassPool(void);
+
+		public:
+			// Gets the size of the region needed by <tt>Initialize</tt>.
+			static size_t GetRequiredSize(void);
+			// Gets the size class of <tt>size</tt>, or <tt>SIZE_CLASS_POOL_CLASS_NUM</tt> if it is too large.
+			static u32 GetClassIndex(const size_t size);
+			// Gets the size of the blocks of a size class.
+			static size_t GetClassSize(const u32 classIndex);
+
+		public:
+			/*!
+				@brief Splits a region into the slabs of the size classes.
+
+				@param[in] regionAddr  Specifies the start address of the region. It must be 8-byte aligned.
+				@param[in] regionSize  Specifies the size of the region. It must be at least <tt>GetRequiredSize()</tt>.
+			*/
+			void Initialize(void* regionAddr, const size_t regionSize);
+			void Finalize(void);
+
+		public:
+			// Returns <tt>NULL</tt> if all the blocks of the class are used.
+			void* Allocate(const u32 classIndex);
+			// <tt>ptr</tt> must be a block of this pool.
+			void Free(void* ptr);
+			bool IsInPool(const void* ptr) const;
+			// Gets the size class of a block of this pool.
+			u32 GetBlockClassIndex(const void* ptr) const;
+
+		public:
+			u32	 GetBlockNum(const u32 classIndex) const;
+			u32	 GetUsedBlockNum(const u32 classIndex) const;
+			u32	 GetPeakUsedBlockNum(const u32 classIndex) const;
+			// Gets the number of allocations that went to the heap because the class was full.
+			u32	 GetExhaustedNum(const u32 classIndex) const;
+			void AddExhaustedNum(const u32 classIndex);
+			void Print(void) const;
+
+		protected:
+			bool m_InitializeFlag;
+			u8	 m_Padding[3];
+
+			uptr  m_ClassStartAddrArray[SIZE_CLASS_POOL_CLASS_NUM + 1];
+			void* m_pFreeListArray[SIZE_CLASS_POOL_CLASS_NUM];
+			u32	  m_UsedBlockNumArray[SIZE_CLASS_POOL_CLASS_NUM];
+			u32	  m_PeakUsedBlockNumArray[SIZE_CLASS_POOL_CLASS_NUM];
+			u32	  m_ExhaustedNumArray[SIZE_CLASS_POOL_CLASS_NUM];
+		};
+	}  // namespace detail
+
+}}	// namespace nn::graphics
+
+#endif
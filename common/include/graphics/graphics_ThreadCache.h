@@ -0,0 +1,63 @@
+#ifndef GRAPHICS_THREAD_CACHE_H_
+#define GRAPHICS_THREAD_CACHE_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	// Maximum number of threads that can have their own cache of small blocks.
+	const u32 GRAPHICS_THREAD_CACHE_MAX_NUM = 4;
+
+	namespace detail {
+		// Number of size classes cached per thread. These are the smallest classes of the size class pool: 64, 128 and 256 bytes.
+		const u32 THREAD_CACHE_CLASS_NUM = 3;
+		// Maximum number of free blocks kept per size class. Half of them go back to the size class pool when it is exceeded.
+		const u32 THREAD_CACHE_BLOCK_MAX_NUM = 32;
+		// Number of blocks taken from the size class pool at once when a size class is empty.
+		const u32 THREAD_CACHE_REFILL_NUM = 8;
+
+		/*!
+			@brief Keeps free small blocks for one thread so that it allocates them without locking the central heap.
+
+				   A cache is only used by the thread it is bound to. The free blocks are linked through their own first word.
+		*/
+		class ThreadCache : private nn::util::NonCopyable<ThreadCache>
+		{
+		public:
+			ThreadCache(void);
+			virtual ~ThreadCache(void);
+
+		public:
+			void  Bind(const bit32 threadId);
+			void  Unbind(void);
+			bool  IsBound(void) const;
+			bit32 GetThreadId(void) const;
+
+		public:
+			// Returns <tt>NULL</tt> if the size class is empty.
+			void* Pop(const u32 classIndex);
+			// Returns <tt>false</tt> if the size class is full.
+			bool Push(const u32 classIndex, void* pBlock);
+			u32	 GetBlockNum(const u32 classIndex) const;
+
+		public:
+			u32	 GetHitNum(void) const;
+			u32	 GetMissNum(void) const;
+			void AddHitNum(void);
+			void AddMissNum(void);
+
+		protected:
+			bool m_BoundFlag;
+			u8	 m_Padding[3];
+
+			bit32 m_ThreadId;
+			void* m_pFreeListArray[THREAD_CACHE_CLASS_NUM];
+			u32	  m_BlockNumArray[THREAD_CACHE_CLASS_NUM];
+			u32	  m_HitNum;
+			u32	  m_MissNum;
+		};
+	}  // namespace detail
+
+}}	// namespace nn::graphics
+
+#endif
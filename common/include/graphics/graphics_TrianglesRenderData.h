@@ -91,6 +91,27 @@ namespace nn { namespace graphics {
 	/*!
 	:private
 
+	@brief Specifies the number of triangles that the arrays of the <tt>TrianglesRenderData</tt> class hold before they first grow.
+	*/
+	const u32 INITIAL_TRIANGLES_NUM = 32;
+
+	/*!
+	:private
+
+	@brief Specifies the maximum number of vertex and index buffers that the <tt>TrianglesRenderData</tt> class uploads to in turn.
+	*/
+	const u32 MAX_VERTEX_BUFFER_RING_NUM = 2;
+
+	/*!
+	:private
+
+	@brief Specifies the number of arrays of the <tt>TrianglesRenderData</tt> class: the five vertex attributes and the indices.
+	*/
+	const u32 VERTEX_ARRAY_NUM = 6;
+
+	/*!
+	:private
+
 	@brief Specifies the data type of vertex buffers.
 	*/
 	const GLenum ARRAY_BUFFER_DATA_TYPE = GL_ARRAY_BUFFER;
@@ -159,6 +180,19 @@ namespace nn { namespace graphics {
 		void SetTrianglesNum(const u32 trianglesNum);
 		void CreateArrays(void);
 		void DestroyArrays(void);
+		void ReserveArrays(const u32 verticesNum, const u32 trianglesNum);
+		void ResizeArrays(const u32 vertexCapacity, const u32 triangleCapacity);
+
+	public:
+		/*!
+		:private
+
+		@brief Shrinks the vertex and index arrays to the largest number of vertices and triangles used so far.
+
+			   The arrays start small and double when more vertices are packed, up to the maximum numbers given to
+		<tt>InitializeVertexBuffers</tt>. Call this function after a warm-up period to release the unused part. The arrays grow again if needed.
+		*/
+		void TrimArrays(void);
 
 	public:
 		/*!
@@ -225,6 +259,31 @@ namespace nn { namespace graphics {
 		*/
 		void DrawPackedTriangles(void);
 
+		/*!
+		:private
+
+		@brief Uploads the packed triangles so that ranges of them can be drawn with <tt>DrawPackedRange</tt>.
+		*/
+		void BeginPackedDraw(void);
+
+		/*!
+		:private
+
+		@brief Draws a range of the indices of the packed triangles. Call this function between <tt>BeginPackedDraw</tt> and
+		<tt>EndPackedDraw</tt>.
+
+		@param[in] firstIndex  Specifies the first index to draw.
+		@param[in] indicesNum  Specifies the number of indices to draw.
+		*/
+		void DrawPackedRange(const u32 firstIndex, const u32 indicesNum);
+
+		/*!
+		:private
+
+		@brief Ends drawing the ranges of the packed triangles and sets the number of packed triangles to zero.
+		*/
+		void EndPackedDraw(void);
+
 	public:
 		/*!
 		:private
@@ -255,8 +314,40 @@ namespace nn { namespace graphics {
 		*/
 		void SetUpdateBufferBeforeDraw(const bool updateBufferFlag);
 
+		/*!
+		:private
+
+		@brief Sets the number of vertex and index buffers that the uploads go to in turn.
+
+			   Each call to <tt>UpdateBuffers</tt> writes to the next buffers of the ring, so the CPU does not have to wait for a
+		command list in flight that still reads the previous ones. Use one buffer per command list. The default is 1.
+
+		@param[in] bufferRingNum  Specifies the number of buffers, 1 to <tt>MAX_VERTEX_BUFFER_RING_NUM</tt>.
+		*/
+		void SetVertexBufferRingNum(const u32 bufferRingNum);
+
+		/*!
+		:private
+
+		@brief Sets whether the GPU reads the vertex and index arrays directly instead of copies of them.
+
+			   In this mode, each array is registered as a vertex or index buffer without a copy, so the primitives are written
+		straight into the memory that is drawn and <tt>Draw</tt> does not upload anything. Each entry of the buffer ring has its own
+		arrays; after the packed triangles are drawn, the next entry is packed while the GPU reads the previous one. Call this
+		function before <tt>InitializeVertexBuffers</tt>. The default is <tt>false</tt>.
+
+		@param[in] directFlag  Specifies <tt>true</tt> to draw from the arrays directly.
+		*/
+		void SetDirectVertexBuffer(const bool directFlag);
+
 	protected:
 		void DestroyBuffers(void);
+		void SwapDirectBuffer(void);
+		void ShrinkArraysToHighWater(void);
+		void BindDirectBuffers(void);
+		void EnableDirectVertexAttributes(void);
+		void* GetArray(const u32 arrayIndex) const;
+		void  SetArray(const u32 arrayIndex, void* pArray);
 
 	public:
 		/*!
@@ -523,6 +614,10 @@ namespace nn { namespace graphics {
 		u32	   m_TrianglesNum;
 		u32	   m_PackedVerticesNum;
 		u32	   m_PackedTrianglesNum;
+		u32	   m_VertexCapacity;
+		u32	   m_TriangleCapacity;
+		u32	   m_HighWaterVerticesNum;
+		u32	   m_HighWaterTrianglesNum;
 
 	protected:
 		u32 m_PositionArraySize;
@@ -531,10 +626,7 @@ namespace nn { namespace graphics {
 		u32 m_NormalArraySize;
 		u32 m_TangentArraySize;
 		u32 m_TotalArraySize;
-		u32 m_OldTotalArraySize;
-
 		u32 m_IndexArraySize;
-		u32 m_OldIndexArraySize;
 
 	protected:
 		GLfloat*  m_PositionArray;
@@ -548,11 +640,35 @@ namespace nn { namespace graphics {
 		GLuint m_ArrayBufferId;
 		GLuint m_ElementArrayBufferId;
 
+		u32	   m_BufferRingNum;
+		u32	   m_BufferRingIndex;
+		GLuint m_ArrayBufferIdArray[MAX_VERTEX_BUFFER_RING_NUM];
+		GLuint m_ElementArrayBufferIdArray[MAX_VERTEX_BUFFER_RING_NUM];
+		u32	   m_ArrayBufferSizeArray[MAX_VERTEX_BUFFER_RING_NUM];
+		u32	   m_ElementArrayBufferSizeArray[MAX_VERTEX_BUFFER_RING_NUM];
+
+	protected:
+		// Arrays and buffers of one entry of the ring in direct vertex buffer mode.
+		struct DirectBuffer
+		{
+			void*		m_pArrayArray[VERTEX_ARRAY_NUM];
+			u32			m_VertexCapacity;
+			u32			m_TriangleCapacity;
+			GLuint		m_BufferIdArray[VERTEX_ARRAY_NUM];
+			const void* m_pBoundArrayArray[VERTEX_ARRAY_NUM];
+			u32			m_BoundSizeArray[VERTEX_ARRAY_NUM];
+		};
+
+		DirectBuffer m_DirectBufferArray[MAX_VERTEX_BUFFER_RING_NUM];
+		u32			 m_PendingTrimNum;
+
 	protected:
 		bool m_InitArrayFlag;
 		bool m_InitBufferFlag;
 		bool m_UpdateBufferFlag;
 		bool m_UpdateAttributesFlag;
+		bool m_DirectVertexBufferFlag;
+		bool m_Padding[3];
 
 	protected:
 		f32 m_PositionX;
@@ -0,0 +1,75 @@
+#ifndef GRAPHICS_UNIFORM_LOCATION_TABLE_H_
+#define GRAPHICS_UNIFORM_LOCATION_TABLE_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	/*!
+	:private
+
+	@brief Enumerates the uniforms that the shader programs of the library use, in the order of their uniform location tables.
+	*/
+	enum ProgramUniform
+	{
+		// Vertex uniform. The matrices come first so that they also index the matrix values cached by <tt>ProgramObject</tt>.
+		PROGRAM_UNIFORM_PROJECTION = 0,
+		PROGRAM_UNIFORM_MODELVIEW,
+		// Fragment uniform: Alpha test.
+		PROGRAM_UNIFORM_ALPHA_TEST,
+		// Fragment uniform: Texture <tt>samplerType</tt>.
+		PROGRAM_UNIFORM_TEXTURE0_SAMPLER_TYPE,
+		PROGRAM_UNIFORM_TEXTURE1_SAMPLER_TYPE,
+		PROGRAM_UNIFORM_TEXTURE2_SAMPLER_TYPE,
+		PROGRAM_UNIFORM_TEXTURE3_SAMPLER_TYPE,
+		// Fragment uniform: Texture <tt>combiner2</tt>.
+		PROGRAM_UNIFORM_TEXENV2_SRC_RGB,
+		PROGRAM_UNIFORM_TEXENV2_SRC_ALPHA,
+		PROGRAM_UNIFORM_TEXENV2_OPERAND_RGB,
+		PROGRAM_UNIFORM_TEXENV2_OPERAND_ALPHA,
+		PROGRAM_UNIFORM_TEXENV2_COMBINE_RGB,
+		PROGRAM_UNIFORM_TEXENV2_COMBINE_ALPHA,
+		PROGRAM_UNIFORM_TEXENV2_CONST_RGBA,
+		// Number of uniforms.
+		PROGRAM_UNIFORMS_NUM
+	};
+
+	/*!
+		:private
+
+		@brief Holds the locations of the uniforms used by the shader programs linked from one shader binary.
+
+		The vertex shaders of a binary bind their uniforms to the same registers and the fragment uniforms are reserved, so the
+		locations are looked up once, with the first program linked from the binary, and shared by the other programs. For a binary
+		of a title, the locations are checked again for each program, and a program whose locations differ must use a table of its
+		own. The bindings of the basic shader binary are known, so its table is not checked.
+	*/
+
+	class UniformLocationTable : private nn::util::NonCopyable<UniformLocationTable>
+	{
+	public:
+		UniformLocationTable(void);
+		virtual ~UniformLocationTable(void);
+
+	public:
+		// Looks up the locations the first time it is called. Later calls check them if checking is enabled and return
+		// <tt>false</tt> if they differ.
+		bool Initialize(const GLuint programId);
+		// Finalize enables checking again.
+		void Finalize(void);
+		void SetCheckFlag(const bool flag);
+
+	public:
+		GLint GetLocation(const u32 uniformIndex) const;
+
+	protected:
+		bool m_Initialized;
+		bool m_CheckFlag;
+		u8	 m_Padding[2];
+
+		GLint m_LocationArray[PROGRAM_UNIFORMS_NUM];
+	};
+
+}}	// namespace nn::graphics
+
+#endif
@@ -174,20 +174,6 @@ namespace nn { namespace graphics {
 	/*!
 	:private
 
-	@brief Specifies an array storing shader uniform locations.
-	*/
-	extern s32 s_UniformLocations[MAX_UNIFORM_LOCATIONS_NUM];
-
-	/*!
-	:private
-
-	@brief Initializes the array for storing shader uniform locations.
-	*/
-	void InitializeUniforms(const GLuint programId);
-
-	/*!
-	:private
-
 	@brief Returns a random color.
 	*/
 	void GetRandomColor(f32& red, f32& green, f32& blue);
@@ -0,0 +1,136 @@
+#ifndef GRAPHICS_VRAM_ALLOCATOR_H_
+#define GRAPHICS_VRAM_ALLOCATOR_H_
+
+#include "graphics/graphics_Utility.h"
+
+namespace nn { namespace graphics {
+
+	namespace detail {
+		// Allocation granularity of VRAM. Every block address and size is a multiple of this value.
+		const u32 VRAM_ALLOCATOR_MIN_ALIGNMENT = 16;
+		// Number of first-level size classes (one per power of two).
+		const u32 VRAM_ALLOCATOR_FL_INDEX_NUM = 32;
+		// Number of second-level size classes per power of two, as log2.
+		const u32 VRAM_ALLOCATOR_SL_INDEX_LOG2 = 3;
+		const u32 VRAM_ALLOCATOR_SL_INDEX_NUM  = (1 << VRAM_ALLOCATOR_SL_INDEX_LOG2);
+		// Maximum number of blocks (free and allocated) managed in one VRAM bank.
+		const u32 VRAM_ALLOCATOR_BLOCK_MAX_NUM = 512;
+
+		/*!
+			@brief Manages one VRAM bank with a two-level segregated fit (TLSF) allocator.
+
+				   Block headers cannot be stored in VRAM, so they are kept in a fixed table of this class.
+				   Allocation and deallocation of free blocks are O(1). Adjacent free blocks are merged on deallocation.
+				   The purpose and the ID of each allocated block are recorded so they can be checked when the block is freed.
+		*/
+		class VramAllocator : private nn::util::NonCopyable<VramAllocator>
+		{
+		public:
+			VramAllocator(void);
+			virtual ~VramAllocator(void);
+
+		public:
+			/*!
+				@brief Initializes the allocator with the region of a VRAM bank.
+
+				@param[in] startAddr  Specifies the start address of the region.
+				@param[in] size  Specifies the size of the region.
+			*/
+			void Initialize(const uptr startAddr, const size_t size);
+			void Finalize(void);
+
+		public:
+			/*!
+				@brief Allocates a block.
+
+				@param[in] size  Specifies the size of the block.
+				@param[in] alignment  Specifies the alignment of the block address. It must be a power of two.
+				@param[in] aim  Specifies the purpose of the block.
+				@param[in] id  Specifies the ID of the block.
+
+				@return Returns the address of the block, or <tt>NULL</tt> if there is no free block large enough.
+			*/
+			void* Allocate(const size_t size, const u32 alignment, const GLenum aim, const GLuint id);
+
+			/*!
+				@brief Frees a block allocated by <tt>Allocate</tt>.
+
+				@param[in] addr  Specifies the address of the block.
+				@param[in] aim  Specifies the purpose of the block. It must be the same as the one given to <tt>Allocate</tt>.
+				@param[in] id  Specifies the ID of the block. It must be the same as the one given to <tt>Allocate</tt>.
+
+				@return Returns <tt>true</tt> if the block was freed; returns <tt>false</tt> if <tt>addr</tt> is not an allocated block.
+			*/
+			bool Free(void* addr, const GLenum aim, const GLuint id);
+
+			// Checks whether a block of <tt>size</tt> bytes aligned to <tt>alignment</tt> can be allocated now.
+			bool CanAllocate(const size_t size, const u32 alignment) const;
+			// Checks whether <tt>addr</tt> is in the region managed by this allocator.
+			bool IsInRegion(const void* addr) const;
+
+		public:
+			size_t GetTotalSize(void) const;
+			size_t GetUsedSize(void) const;
+			size_t GetPeakUsedSize(void) const;
+			size_t GetFreeSize(void) const;
+			size_t GetLargestFreeBlockSize(void) const;
+			u32	   GetFreeBlockNum(void) const;
+			u32	   GetAllocatedBlockNum(void) const;
+			/*!
+				@brief Gets the fragmentation of the free space.
+
+				@return Returns the percentage of the free space that is not in the largest free block.
+			*/
+			u32 GetFragmentationPercent(void) const;
+
+			void Print(const char* name) const;
+
+		protected:
+			struct Block
+			{
+				uptr   m_Addr;
+				size_t m_Size;
+				Block* m_pPrevPhysical;
+				Block* m_pNextPhysical;
+				// Links of the free list while the block is free, of the spare list while the block is not used.
+				Block* m_pPrevFree;
+				Block* m_pNextFree;
+				GLenum m_Aim;
+				GLuint m_Id;
+				bool   m_FreeFlag;
+				u8	   m_Padding[3];
+			};
+
+		protected:
+			Block* GetSpareBlock(void);
+			void   ReleaseSpareBlock(Block* pBlock);
+			void   InsertFreeBlock(Block* pBlock);
+			void   RemoveFreeBlock(Block* pBlock);
+			Block* FindFreeBlock(const size_t size);
+			Block* SplitBlock(Block* pBlock, const size_t size);
+			Block* MergeBlock(Block* pBlock, Block* pNextBlock);
+
+		protected:
+			bool m_InitializeFlag;
+			u8	 m_Padding[3];
+
+			uptr   m_StartAddr;
+			size_t m_TotalSize;
+			size_t m_UsedSize;
+			size_t m_PeakUsedSize;
+			u32	   m_AllocatedBlockNum;
+			u32	   m_FreeBlockNum;
+
+			u32	   m_FlBitmap;
+			u32	   m_SlBitmapArray[VRAM_ALLOCATOR_FL_INDEX_NUM];
+			Block* m_pFreeBlockArray2d[VRAM_ALLOCATOR_FL_INDEX_NUM][VRAM_ALLOCATOR_SL_INDEX_NUM];
+
+			Block* m_pFirstBlock;
+			Block* m_pSpareBlock;
+			Block  m_BlockArray[VRAM_ALLOCATOR_BLOCK_MAX_NUM];
+		};
+	}  // namespace detail
+
+}}	// namespace nn::graphics
+
+#endif
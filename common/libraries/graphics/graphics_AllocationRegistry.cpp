@@ -0,0 +1,368 @@
+#include "graphics/graphics_AllocationRegistry.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		// Maximum number of blocks sorted by PrintLiveBlocks.
+		const u32 SORTED_BLOCK_MAX_NUM = detail::ALLOCATION_REGISTRY_BLOCK_MAX_NUM;
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>MemorySnapshot</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	MemorySnapshot::MemorySnapshot(void)
+	: m_Serial(0)
+	{
+		for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+		{
+			for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+			{
+				m_LiveSizeArray2d[areaIndex][aimIndex] = 0;
+				m_LiveNumArray2d[areaIndex][aimIndex]  = 0;
+				m_PeakSizeArray2d[areaIndex][aimIndex] = 0;
+			}
+		}
+	}
+
+	MemorySnapshot::~MemorySnapshot(void) {}
+
+	size_t MemorySnapshot::GetTotalLiveSize(void) const
+	{
+		size_t totalSize = 0;
+		for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+		{
+			for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+			{
+				totalSize += m_LiveSizeArray2d[areaIndex][aimIndex];
+			}
+		}
+
+		return totalSize;
+	}
+
+	bool MemorySnapshot::HasSameLiveSize(const MemorySnapshot& rhs) const
+	{
+		for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+		{
+			for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+			{
+				if (m_LiveSizeArray2d[areaIndex][aimIndex] != rhs.m_LiveSizeArray2d[areaIndex][aimIndex])
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void MemorySnapshot::Print(void) const
+	{
+		NN_LOG("MemorySnapshot (serial %d, total live 0x%X)\n", m_Serial, GetTotalLiveSize());
+		for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+		{
+			for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+			{
+				if (m_PeakSizeArray2d[areaIndex][aimIndex] == 0)
+				{
+					continue;
+				}
+
+				NN_LOG("  %-6s %-13s : live 0x%06X in %4d blocks, peak 0x%06X\n",
+					   detail::GetMemoryAreaName(areaIndex),
+					   detail::GetMemoryAimName(aimIndex),
+					   m_LiveSizeArray2d[areaIndex][aimIndex],
+					   m_LiveNumArray2d[areaIndex][aimIndex],
+					   m_PeakSizeArray2d[areaIndex][aimIndex]);
+			}
+		}
+	}
+
+	void MemorySnapshot::PrintDifference(const MemorySnapshot& before) const
+	{
+		NN_LOG("MemorySnapshot difference (serial %d -> %d)\n", before.m_Serial, m_Serial);
+		for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+		{
+			for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+			{
+				s32 sizeDifference = static_cast<s32>(m_LiveSizeArray2d[areaIndex][aimIndex] - before.m_LiveSizeArray2d[areaIndex][aimIndex]);
+				s32 numDifference  = static_cast<s32>(m_LiveNumArray2d[areaIndex][aimIndex] - before.m_LiveNumArray2d[areaIndex][aimIndex]);
+				if ((sizeDifference == 0) && (numDifference == 0))
+				{
+					continue;
+				}
+
+				NN_LOG("  %-6s %-13s : live %+d bytes, %+d blocks\n",
+					   detail::GetMemoryAreaName(areaIndex),
+					   detail::GetMemoryAimName(aimIndex),
+					   sizeDifference,
+					   numDifference);
+			}
+		}
+	}
+
+	namespace detail {
+		u32 GetMemoryAreaIndex(const GLenum area)
+		{
+			switch (area)
+			{
+				case NN_GX_MEM_FCRAM:
+					return 0;
+				case NN_GX_MEM_VRAMA:
+					return 1;
+				case NN_GX_MEM_VRAMB:
+					return 2;
+				default:
+					return GRAPHICS_MEMORY_AREA_NUM;
+			}
+		}
+
+		u32 GetMemoryAimIndex(const GLenum aim)
+		{
+			switch (aim)
+			{
+				case NN_GX_MEM_SYSTEM:
+					return 0;
+				case NN_GX_MEM_TEXTURE:
+					return 1;
+				case NN_GX_MEM_VERTEXBUFFER:
+					return 2;
+				case NN_GX_MEM_RENDERBUFFER:
+					return 3;
+				case NN_GX_MEM_DISPLAYBUFFER:
+					return 4;
+				case NN_GX_MEM_COMMANDBUFFER:
+					return 5;
+				default:
+					return GRAPHICS_MEMORY_AIM_NUM;
+			}
+		}
+
+		const char* GetMemoryAreaName(const u32 areaIndex)
+		{
+			static const char* const s_AreaNameArray[GRAPHICS_MEMORY_AREA_NUM] = {"FCRAM", "VRAM-A", "VRAM-B"};
+
+			return (areaIndex < GRAPHICS_MEMORY_AREA_NUM) ? s_AreaNameArray[areaIndex] : "Unknown";
+		}
+
+		const char* GetMemoryAimName(const u32 aimIndex)
+		{
+			static const char* const s_AimNameArray[GRAPHICS_MEMORY_AIM_NUM] = {
+				"System", "Texture", "VertexBuffer", "RenderBuffer", "DisplayBuffer", "CommandBuffer"};
+
+			return (aimIndex < GRAPHICS_MEMORY_AIM_NUM) ? s_AimNameArray[aimIndex] : "Unknown";
+		}
+
+		/* ------------------------------------------------------------------------
+			<tt>AllocationRegistry</tt> Class Member Function
+		------------------------------------------------------------------------ */
+
+		AllocationRegistry::AllocationRegistry(void)
+		: m_InitializeFlag(false)
+		, m_EntryNum(0)
+		, m_NextSerial(0)
+		, m_UntrackedNum(0)
+		{
+		}
+
+		AllocationRegistry::~AllocationRegistry(void) { Finalize(); }
+
+		void AllocationRegistry::Initialize(void)
+		{
+			if (m_InitializeFlag)
+			{
+				return;
+			}
+
+			for (u32 slot = 0; slot < ALLOCATION_REGISTRY_SLOT_NUM; slot++)
+			{
+				m_EntryArray[slot].m_Addr = 0;
+			}
+
+			for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+			{
+				for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+				{
+					m_LiveSizeArray2d[areaIndex][aimIndex] = 0;
+					m_LiveNumArray2d[areaIndex][aimIndex]  = 0;
+					m_PeakSizeArray2d[areaIndex][aimIndex] = 0;
+				}
+			}
+
+			m_EntryNum	   = 0;
+			m_NextSerial   = 0;
+			m_UntrackedNum = 0;
+
+			m_InitializeFlag = true;
+		}
+
+		void AllocationRegistry::Finalize(void)
+		{
+			if (m_InitializeFlag)
+			{
+				m_InitializeFlag = false;
+			}
+		}
+
+		void AllocationRegistry::Register(const GLenum area, const GLenum aim, const GLuint id, const void* addr, const size_t size)
+		{
+			u32 areaIndex = GetMemoryAreaIndex(area);
+			u32 aimIndex  = GetMemoryAimIndex(aim);
+			if (!m_InitializeFlag || (addr == NULL) || (areaIndex == GRAPHICS_MEMORY_AREA_NUM) || (aimIndex == GRAPHICS_MEMORY_AIM_NUM))
+			{
+				return;
+			}
+
+			if (m_EntryNum >= ALLOCATION_REGISTRY_BLOCK_MAX_NUM)
+			{
+				if (m_UntrackedNum == 0)
+				{
+					NN_TLOG_("[graphics::AllocationRegistry] Too many blocks. Increase ALLOCATION_REGISTRY_SLOT_NUM_LOG2.\n");
+				}
+				m_UntrackedNum++;
+				return;
+			}
+
+			u32 slot = GetHomeSlot(reinterpret_cast<uptr>(addr));
+			while (m_EntryArray[slot].m_Addr != 0)
+			{
+				slot = (slot + 1) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+			}
+
+			Entry& entry	  = m_EntryArray[slot];
+			entry.m_Addr	  = reinterpret_cast<uptr>(addr);
+			entry.m_Size	  = size;
+			entry.m_Serial	  = m_NextSerial++;
+			entry.m_Id		  = id;
+			entry.m_AreaIndex = static_cast<u8>(areaIndex);
+			entry.m_AimIndex  = static_cast<u8>(aimIndex);
+			m_EntryNum++;
+
+			m_LiveSizeArray2d[areaIndex][aimIndex] += size;
+			m_LiveNumArray2d[areaIndex][aimIndex] += 1;
+			if (m_LiveSizeArray2d[areaIndex][aimIndex] > m_PeakSizeArray2d[areaIndex][aimIndex])
+			{
+				m_PeakSizeArray2d[areaIndex][aimIndex] = m_LiveSizeArray2d[areaIndex][aimIndex];
+			}
+		}
+
+		bool AllocationRegistry::Unregister(const void* addr)
+		{
+			if (!m_InitializeFlag || (addr == NULL))
+			{
+				return false;
+			}
+
+			u32 slot = GetHomeSlot(reinterpret_cast<uptr>(addr));
+			while (m_EntryArray[slot].m_Addr != reinterpret_cast<uptr>(addr))
+			{
+				if (m_EntryArray[slot].m_Addr == 0)
+				{
+					return false;
+				}
+				slot = (slot + 1) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+			}
+
+			const Entry& entry = m_EntryArray[slot];
+			m_LiveSizeArray2d[entry.m_AreaIndex][entry.m_AimIndex] -= entry.m_Size;
+			m_LiveNumArray2d[entry.m_AreaIndex][entry.m_AimIndex] -= 1;
+			m_EntryNum--;
+
+			// Shift the following entries of the probe sequence back so that no lookup stops at the emptied slot.
+			u32 emptySlot = slot;
+			u32 nextSlot  = (slot + 1) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+			while (m_EntryArray[nextSlot].m_Addr != 0)
+			{
+				u32 homeSlot = GetHomeSlot(m_EntryArray[nextSlot].m_Addr);
+				// The entry can move to the empty slot only if its home slot is not between the empty slot and its own slot.
+				u32 distanceToHome	= (nextSlot - homeSlot) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+				u32 distanceToEmpty = (nextSlot - emptySlot) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+				if (distanceToHome >= distanceToEmpty)
+				{
+					m_EntryArray[emptySlot] = m_EntryArray[nextSlot];
+					emptySlot				= nextSlot;
+				}
+				nextSlot = (nextSlot + 1) & (ALLOCATION_REGISTRY_SLOT_NUM - 1);
+			}
+			m_EntryArray[emptySlot].m_Addr = 0;
+
+			return true;
+		}
+
+		void AllocationRegistry::GetSnapshot(MemorySnapshot& snapshot) const
+		{
+			snapshot.m_Serial = m_NextSerial;
+			for (u32 areaIndex = 0; areaIndex < GRAPHICS_MEMORY_AREA_NUM; areaIndex++)
+			{
+				for (u32 aimIndex = 0; aimIndex < GRAPHICS_MEMORY_AIM_NUM; aimIndex++)
+				{
+					snapshot.m_LiveSizeArray2d[areaIndex][aimIndex] = m_LiveSizeArray2d[areaIndex][aimIndex];
+					snapshot.m_LiveNumArray2d[areaIndex][aimIndex]	= m_LiveNumArray2d[areaIndex][aimIndex];
+					snapshot.m_PeakSizeArray2d[areaIndex][aimIndex] = m_PeakSizeArray2d[areaIndex][aimIndex];
+				}
+			}
+		}
+
+		void AllocationRegistry::PrintLiveBlocks(const u32 maxNum, const MemoryBlockSortKey sortKey, const MemorySnapshot* pSince) const
+		{
+			u32 sinceSerial = (pSince != NULL) ? pSince->m_Serial : 0;
+
+			// Insertion sort of the slot numbers; this is only for debug output.
+			u16 sortedSlotArray[SORTED_BLOCK_MAX_NUM];
+			u32 sortedNum = 0;
+			for (u32 slot = 0; slot < ALLOCATION_REGISTRY_SLOT_NUM; slot++)
+			{
+				const Entry& entry = m_EntryArray[slot];
+				if ((entry.m_Addr == 0) || (entry.m_Serial < sinceSerial) || (sortedNum >= SORTED_BLOCK_MAX_NUM))
+				{
+					continue;
+				}
+
+				u32 index = sortedNum;
+				for (; (index > 0) && IsBefore(entry, m_EntryArray[sortedSlotArray[index - 1]], sortKey); index--)
+				{
+					sortedSlotArray[index] = sortedSlotArray[index - 1];
+				}
+				sortedSlotArray[index] = static_cast<u16>(slot);
+				sortedNum++;
+			}
+
+			NN_LOG("Live blocks (%d blocks since serial %d, %d untracked)\n", sortedNum, sinceSerial, m_UntrackedNum);
+			for (u32 index = 0; (index < sortedNum) && (index < maxNum); index++)
+			{
+				const Entry& entry = m_EntryArray[sortedSlotArray[index]];
+				NN_LOG("  0x%08X size 0x%06X %-6s %-13s id %4d serial %d\n",
+					   entry.m_Addr,
+					   entry.m_Size,
+					   GetMemoryAreaName(entry.m_AreaIndex),
+					   GetMemoryAimName(entry.m_AimIndex),
+					   entry.m_Id,
+					   entry.m_Serial);
+			}
+		}
+
+		u32 AllocationRegistry::GetUntrackedNum(void) const { return m_UntrackedNum; }
+
+		u32 AllocationRegistry::GetHomeSlot(const uptr addr) const
+		{
+			// Fibonacci hashing of the address; the low bits are always 0 because of the alignment.
+			return (static_cast<u32>(addr >> 2) * 0x9E3779B1) >> (32 - ALLOCATION_REGISTRY_SLOT_NUM_LOG2);
+		}
+
+		bool AllocationRegistry::IsBefore(const Entry& lhs, const Entry& rhs, const MemoryBlockSortKey sortKey) const
+		{
+			switch (sortKey)
+			{
+				case MEMORY_BLOCK_SORT_KEY_SIZE:
+					return lhs.m_Size > rhs.m_Size;
+				case MEMORY_BLOCK_SORT_KEY_ADDRESS:
+					return lhs.m_Addr < rhs.m_Addr;
+				case MEMORY_BLOCK_SORT_KEY_SERIAL:
+				default:
+					return lhs.m_Serial < rhs.m_Serial;
+			}
+		}
+	}  // namespace detail
+
+}}	// namespace nn::graphics
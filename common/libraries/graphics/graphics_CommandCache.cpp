@@ -1,5 +1,7 @@
 #include "graphics/graphics_CommandCache.h"
 
+#include <cstring>
+
 namespace nn { namespace graphics {
 
 	namespace detail {
@@ -51,6 +53,8 @@ namespace nn { namespace graphics {
 	, m_CommandRequestBeginId(0)
 	, m_CommandRequestSize(0)
 	, m_CommandBufferAddr(NULL)
+	, m_RemovedCommandNum(0)
+	, m_MergedCommandNum(0)
 	{
 		for (u32 modelIndex = 0; modelIndex < GRAPHICS_MAX_COMMAND_CACHE_MODELS_NUM; modelIndex++)
 		{
@@ -109,6 +113,9 @@ namespace nn { namespace graphics {
 			}
 		}
 
+		m_RemovedCommandNum = 0;
+		m_MergedCommandNum	= 0;
+
 		m_State = COMMAND_CACHE_FINALIZED;
 	}
 
@@ -206,6 +213,62 @@ namespace nn { namespace graphics {
 
 		GRAPHICS_ASSERT_GL_ERROR();
 
+		UpdateVSUniformOffsets();
+
+		m_ModelIndex		= 0;
+		m_RemovedCommandNum = 0;
+		m_MergedCommandNum	= 0;
+
+		// Bind the command list again.
+		nngxBindCmdlist(m_CurrentCommandListId);
+
+		m_State = COMMAND_CACHE_END_SAVE;
+
+		GRAPHICS_ASSERT_GL_ERROR();
+	}
+
+	bool CommandCache::Optimize(void)
+	{
+		if (m_State != COMMAND_CACHE_END_SAVE)
+		{
+			NN_TPANIC_("m_State != COMMAND_CACHE_END_SAVE.\n");
+		}
+
+		// Requests inside the saved range refer to fixed positions in the 3D command buffer, so the buffer can only be
+		// rewritten when the saved range consists of 3D commands alone.
+		if (m_CommandRequestSize != 0)
+		{
+			return false;
+		}
+
+		u32 barrierOffsetArray[GRAPHICS_MAX_COMMAND_CACHE_MODELS_NUM];
+		for (u32 modelIndex = 0; modelIndex < m_TotalModelNum; modelIndex++)
+		{
+			barrierOffsetArray[modelIndex] = m_CommandBufferStartOffsetArray[modelIndex] - m_CommandBufferOffset;
+		}
+
+		u32		removedNum = 0;
+		u32		mergedNum  = 0;
+		GLsizei bufferSize = detail::OptimizeCommandBuffer(
+			m_CommandBufferAddr, m_CommandBufferSize, barrierOffsetArray, m_TotalModelNum, &removedNum, &mergedNum);
+
+		for (u32 modelIndex = 0; modelIndex < m_TotalModelNum; modelIndex++)
+		{
+			m_CommandBufferStartOffsetArray[modelIndex] = barrierOffsetArray[modelIndex] + m_CommandBufferOffset;
+		}
+
+		m_CommandBufferSize = bufferSize;
+		m_RemovedCommandNum += removedNum;
+		m_MergedCommandNum += mergedNum;
+
+		// The commands have moved, so the offsets of the uniform matrices must be searched again.
+		UpdateVSUniformOffsets();
+
+		return true;
+	}
+
+	void CommandCache::UpdateVSUniformOffsets(void)
+	{
 		for (u32 modelIndex = 0; modelIndex < m_TotalModelNum; modelIndex++)
 		{
 			// Get the matrix offset value for the 3D command buffer of the save destination command list.
@@ -225,15 +288,6 @@ namespace nn { namespace graphics {
 				}
 			}
 		}
-
-		m_ModelIndex = 0;
-
-		// Bind the command list again.
-		nngxBindCmdlist(m_CurrentCommandListId);
-
-		m_State = COMMAND_CACHE_END_SAVE;
-
-		GRAPHICS_ASSERT_GL_ERROR();
 	}
 
 	void CommandCache::UpdateVSUniformMatrix(const u32 modelIndex, const u32 uniformMatrixIndex, const nn::math::MTX44& matrix)
@@ -334,6 +388,7 @@ namespace nn { namespace graphics {
 		NN_LOG("  bufferOffset   = %d, bufferSize  = %d\n", m_CommandBufferOffset, m_CommandBufferSize);
 		NN_LOG("  requestBeginId = %d, requestSize = %d\n", m_CommandRequestBeginId, m_CommandRequestSize);
 		NN_LOG("  modelIndex = %d, totalModelNum = %d\n", m_ModelIndex, m_TotalModelNum);
+		NN_LOG("  removedCommandNum = %d, mergedCommandNum = %d\n", m_RemovedCommandNum, m_MergedCommandNum);
 	}
 
 	namespace detail {
@@ -479,6 +534,244 @@ namespace nn { namespace graphics {
 				}
 			}
 		}
+
+		namespace {
+			// Number of registers addressable by a 3D command.
+			const u32 COMMAND_BUFFER_REGISTER_NUM = 0x400;
+
+			// Registers that trigger an operation or feed a data port when written. Writing them again is never redundant.
+			const u16 VOLATILE_REGISTER_RANGE_ARRAY[][2] = {
+				{ 0x010, 0x010 },  // Interrupt request.
+				{ 0x063, 0x063 },  // Early depth buffer clear.
+				{ 0x080, 0x080 },  // Texture unit configuration (texture cache clear bit).
+				{ 0x0af, 0x0b7 },  // Procedural texture LUT index and data.
+				{ 0x0e6, 0x0ef },  // Fog LUT index and data.
+				{ 0x110, 0x111 },  // Frame buffer flush and invalidate.
+				{ 0x1c5, 0x1cf },  // Lighting LUT index and data.
+				{ 0x22e, 0x22f },  // Draw kick.
+				{ 0x231, 0x23d },  // Vertex cache clear, immediate vertex data and command buffer jump.
+				{ 0x245, 0x245 },  // Draw start.
+				{ 0x25f, 0x25f },  // Primitive restart.
+				{ 0x28f, 0x28f },  // Geometry shader code transfer end.
+				{ 0x290, 0x2ad },  // Geometry shader uniform, program and operand descriptor ports.
+				{ 0x2bf, 0x2bf },  // Vertex shader code transfer end.
+				{ 0x2c0, 0x2dd }   // Vertex shader uniform, program and operand descriptor ports.
+			};
+
+			// Shadow of the register values written so far by the buffer being optimized.
+			u32 s_RegisterValueArray[COMMAND_BUFFER_REGISTER_NUM];
+			u32 s_RegisterValidBitArray[COMMAND_BUFFER_REGISTER_NUM / 32];
+
+			bool IsVolatileRegister(const u32 addr)
+			{
+				if (addr >= COMMAND_BUFFER_REGISTER_NUM)
+				{
+					return true;
+				}
+
+				for (u32 i = 0; i < sizeof(VOLATILE_REGISTER_RANGE_ARRAY) / sizeof(VOLATILE_REGISTER_RANGE_ARRAY[0]); i++)
+				{
+					if ((addr >= VOLATILE_REGISTER_RANGE_ARRAY[i][0]) && (addr <= VOLATILE_REGISTER_RANGE_ARRAY[i][1]))
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			bool IsRedundantWrite(const u32 addr, const u32 data)
+			{
+				return (s_RegisterValidBitArray[addr >> 5] & (1u << (addr & 31))) && (s_RegisterValueArray[addr] == data);
+			}
+
+			void SetRegisterValue(const u32 addr, const u32 data, const u32 be)
+			{
+				if (addr >= COMMAND_BUFFER_REGISTER_NUM)
+				{
+					return;
+				}
+
+				if (be == 0xf)
+				{
+					s_RegisterValueArray[addr] = data;
+					s_RegisterValidBitArray[addr >> 5] |= (1u << (addr & 31));
+				}
+				else if (be != 0)
+				{
+					// Partial writes leave the register value unknown.
+					s_RegisterValidBitArray[addr >> 5] &= ~(1u << (addr & 31));
+				}
+			}
+
+			// Write the pending single commands to consecutive registers as one command.
+			u32 WriteMergedCommand(u8* bufferAddress, u32 offset, const u32 addr, const u32* dataArray, const u32 dataNum)
+			{
+				u32* dst = reinterpret_cast<u32*>(&bufferAddress[offset]);
+
+				CommandBuffer3d header;
+				header.data = dataArray[0];
+				header.addr = addr;
+				header.be	= 0xf;
+				header.size = dataNum - 1;
+				header.rsv	= 0;
+				header.seq	= (dataNum > 1) ? 1 : 0;
+				std::memcpy(dst, &header, sizeof(header));
+
+				for (u32 i = 1; i < dataNum; i++)
+				{
+					dst[1 + i] = dataArray[i];
+				}
+
+				offset += dataNum * 4 + 4;
+				if (offset & 4)
+				{
+					// Burst commands are padded to 8 bytes.
+					dst[1 + dataNum] = 0;
+					offset += 4;
+				}
+
+				return offset;
+			}
+		}  // namespace
+
+		GLsizei OptimizeCommandBuffer(u8*			bufferAddress,
+									  const GLsizei bufferSize,
+									  u32*			barrierOffsetArray,
+									  const u32		barrierOffsetNum,
+									  u32*			removedNum,
+									  u32*			mergedNum)
+		{
+			std::memset(s_RegisterValidBitArray, 0, sizeof(s_RegisterValidBitArray));
+
+			u32 pendingAddr = 0;
+			u32 pendingNum	= 0;
+			u32 pendingDataArray[COMMAND_BUFFER_MAX_BURST_NUM];
+
+			*removedNum = 0;
+			*mergedNum	= 0;
+
+			// The output never grows past the input, so the buffer can be rewritten in place.
+			u32 readOffset	= 0;
+			u32 writeOffset = 0;
+			while (true)
+			{
+				bool isBarrier = (readOffset >= static_cast<u32>(bufferSize));
+				for (u32 i = 0; i < barrierOffsetNum; i++)
+				{
+					if (barrierOffsetArray[i] == readOffset)
+					{
+						isBarrier = true;
+					}
+				}
+
+				if (isBarrier)
+				{
+					if (pendingNum > 0)
+					{
+						*mergedNum += (pendingNum > 1) ? pendingNum : 0;
+						writeOffset = WriteMergedCommand(bufferAddress, writeOffset, pendingAddr, pendingDataArray, pendingNum);
+						pendingNum	= 0;
+					}
+
+					for (u32 i = 0; i < barrierOffsetNum; i++)
+					{
+						if (barrierOffsetArray[i] == readOffset)
+						{
+							barrierOffsetArray[i] = writeOffset | 0x80000000;
+						}
+					}
+				}
+
+				if (readOffset >= static_cast<u32>(bufferSize))
+				{
+					break;
+				}
+
+				CommandBuffer3d command;
+				std::memcpy(&command, &bufferAddress[readOffset], sizeof(command));
+
+				if (command.size == 0)
+				{
+					// Single command.
+					if ((command.be == 0xf) && !IsVolatileRegister(command.addr))
+					{
+						if (IsRedundantWrite(command.addr, command.data))
+						{
+							*removedNum += 1;
+						}
+						else
+						{
+							if ((pendingNum > 0) &&
+								((pendingAddr + pendingNum != command.addr) || (pendingNum == COMMAND_BUFFER_MAX_BURST_NUM)))
+							{
+								*mergedNum += (pendingNum > 1) ? pendingNum : 0;
+								writeOffset =
+									WriteMergedCommand(bufferAddress, writeOffset, pendingAddr, pendingDataArray, pendingNum);
+								pendingNum = 0;
+							}
+
+							if (pendingNum == 0)
+							{
+								pendingAddr = command.addr;
+							}
+							pendingDataArray[pendingNum++] = command.data;
+							SetRegisterValue(command.addr, command.data, command.be);
+						}
+
+						readOffset += 8;
+						continue;
+					}
+				}
+
+				// Any other command is kept as it is.
+				if (pendingNum > 0)
+				{
+					*mergedNum += (pendingNum > 1) ? pendingNum : 0;
+					writeOffset = WriteMergedCommand(bufferAddress, writeOffset, pendingAddr, pendingDataArray, pendingNum);
+					pendingNum	= 0;
+				}
+
+				u32 commandSize = 8;
+				if (command.size == 0)
+				{
+					SetRegisterValue(command.addr, command.data, command.be);
+				}
+				else
+				{
+					commandSize = (command.size + 1) * 4 + 4;
+					if (commandSize & 4)
+					{
+						commandSize += 4;
+					}
+
+					const u32* dataArray = reinterpret_cast<const u32*>(&bufferAddress[readOffset]);
+					for (u32 i = 0; i < command.size + 1u; i++)
+					{
+						u32 data = (i == 0) ? command.data : dataArray[1 + i];
+						SetRegisterValue(command.seq ? (command.addr + i) : command.addr, data, command.be);
+					}
+				}
+
+				std::memmove(&bufferAddress[writeOffset], &bufferAddress[readOffset], commandSize);
+				readOffset += commandSize;
+				writeOffset += commandSize;
+			}
+
+			for (u32 i = 0; i < barrierOffsetNum; i++)
+			{
+				if (barrierOffsetArray[i] & 0x80000000)
+				{
+					barrierOffsetArray[i] &= ~0x80000000;
+				}
+				else
+				{
+					NN_TPANIC_("barrierOffsetArray[%d](%d) is not on a command boundary.\n", i, barrierOffsetArray[i]);
+				}
+			}
+
+			return static_cast<GLsizei>(writeOffset);
+		}
 	}  // namespace detail
 
 	void PrintCurrentCmdlist(void)
@@ -1,5 +1,32 @@
 #include "graphics/graphics_CommandList.h"
 
+namespace {
+	u32 RoundUp(const u32 value, const u32 alignment) { return ((value + alignment - 1) / alignment) * alignment; }
+
+	u32 GetPercentile(const u32* valueArray, const u32 valueNum, const u32 percent)
+	{
+		if (valueNum == 0)
+		{
+			return 0;
+		}
+
+		u32 sortedArray[nn::graphics::GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM];
+		for (u32 i = 0; i < valueNum; i++)
+		{
+			u32 value = valueArray[i];
+			u32 j	  = i;
+			for (; (j > 0) && (sortedArray[j - 1] > value); j--)
+			{
+				sortedArray[j] = sortedArray[j - 1];
+			}
+			sortedArray[j] = value;
+		}
+
+		u32 index = ((valueNum - 1) * ((percent > 100) ? 100 : percent) + 99) / 100;
+		return sortedArray[index];
+	}
+}  // namespace
+
 namespace nn { namespace graphics {
 
 	/* ------------------------------------------------------------------------
@@ -9,45 +36,71 @@ namespace nn { namespace graphics {
 	CommandList::CommandList(void)
 	: m_InitializeFlag(false)
 	, m_SerialRunFlag(false)
+	, m_CommandListNum(1)
 	, m_StoreCommandListIndex(0)
 	, m_RunningCommandListIndex(0)
 	, m_BufferSize(0)
 	, m_RequestNum(0)
+	, m_AdaptiveStorageFlag(false)
+	, m_HeadroomPercent(25)
+	, m_StatisticsFrameIndex(0)
+	, m_StatisticsFrameNum(0)
+	, m_PeakUsedBufferSize(0)
+	, m_PeakUsedRequestNum(0)
+	, m_ResizeCount(0)
+	, m_FrameProfilerPtr(NULL)
 	{
 		for (u32 index = 0; index < GRAPHICS_COMMAND_LIST_NUM; index++)
 		{
-			m_CommandListIdArray[index] = 0;
+			m_CommandListIdArray[index]		= 0;
+			m_RunningFlagArray[index]		= false;
+			m_StorageBufferSizeArray[index] = 0;
+			m_StorageRequestNumArray[index] = 0;
 		}
+
+		ResetStatistics();
 	}
 
 	CommandList::~CommandList(void) { Finalize(); }
 
-	void CommandList::Initialize(const GLsizei bufferSize, const GLsizei requestNum, const bool serialRunMode)
+	void CommandList::Initialize(const GLsizei bufferSize, const GLsizei requestNum, const bool serialRunMode, const u32 commandListNum)
 	{
 		if (!m_InitializeFlag)
 		{
 			GRAPHICS_ASSERT_GL_ERROR();
 
+			if ((commandListNum == 0) || (commandListNum > GRAPHICS_COMMAND_LIST_NUM))
+			{
+				NN_TPANIC_("commandListNum(%d) must be 1 to %d.\n", commandListNum, GRAPHICS_COMMAND_LIST_NUM);
+			}
+
+			m_CommandListNum		  = commandListNum;
 			m_StoreCommandListIndex	  = 0;
 			m_RunningCommandListIndex = 0;
 
 			m_BufferSize = bufferSize;
 			m_RequestNum = requestNum;
 
-			nngxGenCmdlists(GRAPHICS_COMMAND_LIST_NUM, &m_CommandListIdArray[0]);
-			for (u32 index = 0; index < GRAPHICS_COMMAND_LIST_NUM; index++)
+			nngxGenCmdlists(m_CommandListNum, &m_CommandListIdArray[0]);
+			for (u32 index = 0; index < m_CommandListNum; index++)
 			{
+				m_RunningFlagArray[index] = false;
+
 				GLuint id = m_CommandListIdArray[index];
 				nngxBindCmdlist(id);
 				nngxCmdlistStorage(m_BufferSize, m_RequestNum);
 				GRAPHICS_ASSERT_GL_ERROR();
 
+				m_StorageBufferSizeArray[index] = m_BufferSize;
+				m_StorageRequestNumArray[index] = m_RequestNum;
+
 				nngxSetCmdlistParameteri(NN_GX_CMDLIST_RUN_MODE, NN_GX_CMDLIST_SERIAL_RUN);
 			}
 			nngxBindCmdlist(m_CommandListIdArray[m_StoreCommandListIndex]);
 			GRAPHICS_ASSERT_GL_ERROR();
 
-			m_SerialRunFlag = serialRunMode;
+			// In the ring, a command list starts when it is run so that it never overlaps the previous one.
+			m_SerialRunFlag = serialRunMode && (m_CommandListNum == 1);
 			if (m_SerialRunFlag)
 			{
 				nngxRunCmdlist();
@@ -68,13 +121,28 @@ namespace nn { namespace graphics {
 		{
 			GRAPHICS_ASSERT_GL_ERROR();
 
-			Clear();
+			if (m_CommandListNum == 1)
+			{
+				Clear();
+			}
+			else
+			{
+				for (u32 index = 0; index < m_CommandListNum; index++)
+				{
+					WaitCommandList(index);
+					nngxBindCmdlist(m_CommandListIdArray[index]);
+					nngxClearCmdlist();
+				}
+			}
 			GRAPHICS_ASSERT_GL_ERROR();
 
-			nngxDeleteCmdlists(GRAPHICS_COMMAND_LIST_NUM, &m_CommandListIdArray[0]);
+			nngxDeleteCmdlists(m_CommandListNum, &m_CommandListIdArray[0]);
 			for (u32 index = 0; index < GRAPHICS_COMMAND_LIST_NUM; index++)
 			{
-				m_CommandListIdArray[index] = 0;
+				m_CommandListIdArray[index]		= 0;
+				m_RunningFlagArray[index]		= false;
+				m_StorageBufferSizeArray[index] = 0;
+				m_StorageRequestNumArray[index] = 0;
 			}
 
 			GRAPHICS_ASSERT_GL_ERROR();
@@ -85,22 +153,80 @@ namespace nn { namespace graphics {
 
 	void CommandList::Run(void)
 	{
-		RunSingle();
+		if (m_CommandListNum == 1)
+		{
+			RunSingle();
+		}
+		else
+		{
+			RunMultiple();
+		}
 
 		GRAPHICS_ASSERT_GL_ERROR();
 	}
 
 	void CommandList::RunSingle(void)
 	{
+		BeginProfile(FRAME_PROFILER_PHASE_SUBMIT);
 		nngxBindCmdlist(m_CommandListIdArray[m_StoreCommandListIndex]);
 		nngxSplitDrawCmdlist();
+		RecordUsage();
 		nngxRunCmdlist();
+		EndProfile(FRAME_PROFILER_PHASE_SUBMIT);
+
+		BeginProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
 		nngxWaitCmdlistDone();
+		EndProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
+	}
+
+	void CommandList::RunMultiple(void)
+	{
+		// The GPU executes one command list at a time, so the previous command list must be done before this one runs.
+		// The drawing classes upload vertex data to a ring of buffers and do not wait themselves, so this is where the CPU waits.
+		WaitRunning();
+
+		BeginProfile(FRAME_PROFILER_PHASE_SUBMIT);
+		nngxBindCmdlist(m_CommandListIdArray[m_StoreCommandListIndex]);
+		nngxSplitDrawCmdlist();
+		RecordUsage();
+		nngxRunCmdlist();
+		EndProfile(FRAME_PROFILER_PHASE_SUBMIT);
+
+		m_RunningFlagArray[m_StoreCommandListIndex] = true;
+		m_RunningCommandListIndex					= m_StoreCommandListIndex;
+	}
+
+	void CommandList::WaitCommandList(const u32 commandListIndex)
+	{
+		if (m_RunningFlagArray[commandListIndex])
+		{
+			BeginProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
+			nngxBindCmdlist(m_CommandListIdArray[commandListIndex]);
+			nngxWaitCmdlistDone();
+			EndProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
+
+			m_RunningFlagArray[commandListIndex] = false;
+		}
 	}
 
 	void CommandList::Swap(void)
 	{
+		if (m_CommandListNum > 1)
+		{
+			// Store the next frame in the next command list of the ring. It is only waited on if the GPU still uses it.
+			m_StoreCommandListIndex = (m_RunningCommandListIndex + 1) % m_CommandListNum;
+			WaitCommandList(m_StoreCommandListIndex);
+
+			nngxBindCmdlist(m_CommandListIdArray[m_StoreCommandListIndex]);
+			nngxClearCmdlist();
+			UpdateStorage(m_StoreCommandListIndex);
+			nngxStopCmdlist();
+
+			return;
+		}
+
 		Clear();
+		UpdateStorage(m_RunningCommandListIndex);
 
 		if (m_SerialRunFlag)
 		{
@@ -119,8 +245,16 @@ namespace nn { namespace graphics {
 
 	void CommandList::Wait(void)
 	{
+		if (m_CommandListNum > 1)
+		{
+			WaitRunning();
+			return;
+		}
+
+		BeginProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
 		nngxBindCmdlist(m_CommandListIdArray[m_RunningCommandListIndex]);
 		nngxWaitCmdlistDone();
+		EndProfile(FRAME_PROFILER_PHASE_GPU_WAIT);
 
 		if (m_SerialRunFlag)
 		{
@@ -132,12 +266,191 @@ namespace nn { namespace graphics {
 		}
 	}
 
+	void CommandList::WaitRunning(void)
+	{
+		if (m_RunningFlagArray[m_RunningCommandListIndex])
+		{
+			WaitCommandList(m_RunningCommandListIndex);
+
+			// Bind the command list being stored again.
+			nngxBindCmdlist(m_CommandListIdArray[m_StoreCommandListIndex]);
+		}
+	}
+
 	void CommandList::Clear(void)
 	{
 		nngxBindCmdlist(m_CommandListIdArray[m_RunningCommandListIndex]);
 		nngxClearCmdlist();
 	}
 
-	void CommandList::SetSerialRun(const bool flag) { m_SerialRunFlag = flag; }
+	void CommandList::SetSerialRun(const bool flag) { m_SerialRunFlag = flag && (m_CommandListNum == 1); }
+
+	u32 CommandList::GetCommandListNum(void) const { return m_CommandListNum; }
+
+	void CommandList::SetFrameProfiler(FrameProfiler* frameProfilerPtr) { m_FrameProfilerPtr = frameProfilerPtr; }
+
+	void CommandList::BeginProfile(const FrameProfilerPhase phase)
+	{
+		if (m_FrameProfilerPtr != NULL)
+		{
+			m_FrameProfilerPtr->Begin(phase);
+		}
+	}
+
+	void CommandList::EndProfile(const FrameProfilerPhase phase)
+	{
+		if (m_FrameProfilerPtr != NULL)
+		{
+			m_FrameProfilerPtr->End(phase);
+		}
+	}
+
+	void CommandList::RecordUsage(void)
+	{
+		GLint usedBufferSize = 0;
+		GLint usedRequestNum = 0;
+		nngxGetCmdlistParameteri(NN_GX_CMDLIST_USED_BUFSIZE, &usedBufferSize);
+		nngxGetCmdlistParameteri(NN_GX_CMDLIST_USED_REQCOUNT, &usedRequestNum);
+
+		m_UsedBufferSizeArray[m_StatisticsFrameIndex] = usedBufferSize;
+		m_UsedRequestNumArray[m_StatisticsFrameIndex] = usedRequestNum;
+		m_StatisticsFrameIndex						  = (m_StatisticsFrameIndex + 1) % GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM;
+		if (m_StatisticsFrameNum < GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM)
+		{
+			m_StatisticsFrameNum++;
+		}
+
+		if (static_cast<u32>(usedBufferSize) > m_PeakUsedBufferSize)
+		{
+			m_PeakUsedBufferSize = usedBufferSize;
+		}
+		if (static_cast<u32>(usedRequestNum) > m_PeakUsedRequestNum)
+		{
+			m_PeakUsedRequestNum = usedRequestNum;
+		}
+
+		if (!m_AdaptiveStorageFlag)
+		{
+			return;
+		}
+
+		// Grow as soon as one frame eats into the headroom.
+		u32 freePercent = 100 - m_HeadroomPercent;
+		if ((static_cast<u32>(usedBufferSize) * 100 > static_cast<u32>(m_BufferSize) * freePercent) ||
+			(static_cast<u32>(usedRequestNum) * 100 > static_cast<u32>(m_RequestNum) * freePercent))
+		{
+			u32 bufferSize = RoundUp(static_cast<u32>(usedBufferSize) * 100 / freePercent + 1, GRAPHICS_COMMAND_LIST_BUFFER_SIZE_ALIGNMENT);
+			u32 requestNum = RoundUp(static_cast<u32>(usedRequestNum) * 100 / freePercent + 1, GRAPHICS_COMMAND_LIST_REQUEST_NUM_ALIGNMENT);
+			if (bufferSize > static_cast<u32>(m_BufferSize))
+			{
+				m_BufferSize = bufferSize;
+			}
+			if (requestNum > static_cast<u32>(m_RequestNum))
+			{
+				m_RequestNum = requestNum;
+			}
+			return;
+		}
+
+		// Shrink only after a full window of frames fits in half of the storage.
+		if (m_StatisticsFrameNum == GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM)
+		{
+			u32 peakBufferSize = GetPercentile(m_UsedBufferSizeArray, m_StatisticsFrameNum, 100);
+			u32 peakRequestNum = GetPercentile(m_UsedRequestNumArray, m_StatisticsFrameNum, 100);
+			u32 bufferSize = RoundUp(peakBufferSize * 100 / freePercent + 1, GRAPHICS_COMMAND_LIST_BUFFER_SIZE_ALIGNMENT);
+			u32 requestNum = RoundUp(peakRequestNum * 100 / freePercent + 1, GRAPHICS_COMMAND_LIST_REQUEST_NUM_ALIGNMENT);
+			if (bufferSize * 2 <= static_cast<u32>(m_BufferSize))
+			{
+				m_BufferSize = bufferSize;
+			}
+			if (requestNum * 2 <= static_cast<u32>(m_RequestNum))
+			{
+				m_RequestNum = requestNum;
+			}
+		}
+	}
+
+	void CommandList::UpdateStorage(const u32 commandListIndex)
+	{
+		if ((m_StorageBufferSizeArray[commandListIndex] == m_BufferSize) && (m_StorageRequestNumArray[commandListIndex] == m_RequestNum))
+		{
+			return;
+		}
+
+		// Storage of a command list that already has storage is released and allocated again.
+		nngxCmdlistStorage(m_BufferSize, m_RequestNum);
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		NN_TLOG_("[graphics::CommandList] Storage of command list %d resized: 0x%X bytes, %d requests -> 0x%X bytes, %d requests\n",
+				 commandListIndex,
+				 m_StorageBufferSizeArray[commandListIndex],
+				 m_StorageRequestNumArray[commandListIndex],
+				 m_BufferSize,
+				 m_RequestNum);
+
+		m_StorageBufferSizeArray[commandListIndex] = m_BufferSize;
+		m_StorageRequestNumArray[commandListIndex] = m_RequestNum;
+		m_ResizeCount++;
+	}
+
+	void CommandList::SetAdaptiveStorage(const bool enable, const u32 headroomPercent)
+	{
+		if ((headroomPercent == 0) || (headroomPercent > 90))
+		{
+			NN_TPANIC_("headroomPercent(%d) must be 1 to 90.\n", headroomPercent);
+		}
+
+		m_AdaptiveStorageFlag = enable;
+		m_HeadroomPercent	  = headroomPercent;
+	}
+
+	GLsizei CommandList::GetBufferSize(void) const { return m_BufferSize; }
+
+	GLsizei CommandList::GetRequestNum(void) const { return m_RequestNum; }
+
+	u32 CommandList::GetPeakUsedBufferSize(void) const { return m_PeakUsedBufferSize; }
+
+	u32 CommandList::GetPeakUsedRequestNum(void) const { return m_PeakUsedRequestNum; }
+
+	u32 CommandList::GetUsedBufferSizePercentile(const u32 percent) const
+	{
+		return GetPercentile(m_UsedBufferSizeArray, m_StatisticsFrameNum, percent);
+	}
+
+	u32 CommandList::GetUsedRequestNumPercentile(const u32 percent) const
+	{
+		return GetPercentile(m_UsedRequestNumArray, m_StatisticsFrameNum, percent);
+	}
+
+	void CommandList::ResetStatistics(void)
+	{
+		for (u32 index = 0; index < GRAPHICS_COMMAND_LIST_STATISTICS_FRAME_NUM; index++)
+		{
+			m_UsedBufferSizeArray[index] = 0;
+			m_UsedRequestNumArray[index] = 0;
+		}
+
+		m_StatisticsFrameIndex = 0;
+		m_StatisticsFrameNum   = 0;
+		m_PeakUsedBufferSize   = 0;
+		m_PeakUsedRequestNum   = 0;
+		m_ResizeCount		   = 0;
+	}
+
+	void CommandList::PrintStatistics(void) const
+	{
+		NN_LOG("CommandList statistics (%d frames)\n", m_StatisticsFrameNum);
+		NN_LOG("  bufferSize : peak = 0x%X, p50 = 0x%X, p99 = 0x%X, storage = 0x%X\n",
+			   m_PeakUsedBufferSize,
+			   GetUsedBufferSizePercentile(50),
+			   GetUsedBufferSizePercentile(99),
+			   m_BufferSize);
+		NN_LOG("  reqCount   : peak = %d, p50 = %d, p99 = %d, storage = %d\n",
+			   m_PeakUsedRequestNum,
+			   GetUsedRequestNumPercentile(50),
+			   GetUsedRequestNumPercentile(99),
+			   m_RequestNum);
+		NN_LOG("  resizeCount = %d\n", m_ResizeCount);
+	}
 
 }}	// namespace nn::graphics
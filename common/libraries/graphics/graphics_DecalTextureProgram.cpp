@@ -1,4 +1,6 @@
 #include "graphics/graphics_DecalTextureProgram.h"
+#include "graphics/graphics_DrawStatistics.h"
+#include "graphics/graphics_GLStateCache.h"
 
 namespace nn { namespace graphics {
 
@@ -66,12 +68,8 @@ namespace nn { namespace graphics {
 			m_ProgramId = 0;
 		}
 
-		// Vertex shader.
-		if (m_ShaderIds[0] != 0)
-		{
-			glDeleteShader(m_ShaderIds[0]);
-			m_ShaderIds[0] = 0;
-		}
+		// Vertex shader. It belongs to the shader binary, which the other programs of the binary share.
+		m_ShaderIds[0] = 0;
 
 		m_Initialized = false;
 
@@ -85,38 +83,50 @@ namespace nn { namespace graphics {
 			return false;
 		}
 
-		glUseProgram(m_ProgramId);
+		UseState();
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_TextureId);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		GLStateCache& stateCache = GetGLStateCache();
+		stateCache.ActiveTexture(GL_TEXTURE0);
+		if (stateCache.BindTexture2d(m_TextureId))
+		{
+			GetCurrentDrawStatistics().m_TextureBindNum += 1;
+		}
+		stateCache.SetTexture2dFilter(GL_NEAREST, GL_NEAREST);
 
-		UpdateModelViewProjectionMatrix();
+		return true;
+	}
+
+	void DecalTextureProgram::SetupState(void)
+	{
+		ProgramObject::SetupState();
 
 		// <tt>uniform</tt> for the reserved fragment shader alpha test.
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_ALPHA_TEST], GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_ALPHA_TEST, GL_FALSE);
 
 		// <tt>uniform</tt> for the reserved fragment shader texture sampler.
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE0_SAMPLER_TYPE], GL_TEXTURE_2D);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE1_SAMPLER_TYPE], GL_FALSE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE2_SAMPLER_TYPE], GL_FALSE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE3_SAMPLER_TYPE], GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE0_SAMPLER_TYPE, GL_TEXTURE_2D);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE1_SAMPLER_TYPE, GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE2_SAMPLER_TYPE, GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE3_SAMPLER_TYPE, GL_FALSE);
 
 		// <tt>uniform</tt> for the reserved fragment shader texture combiner.
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_RGB], GL_TEXTURE0, GL_CONSTANT, GL_CONSTANT);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_ALPHA], GL_TEXTURE0, GL_CONSTANT, GL_CONSTANT);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_RGB], GL_SRC_COLOR, GL_SRC_COLOR, GL_SRC_COLOR);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_ALPHA], GL_SRC_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_RGB], GL_REPLACE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_ALPHA], GL_REPLACE);
-
-		return true;
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_SRC_RGB, GL_TEXTURE0, GL_CONSTANT, GL_CONSTANT);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_SRC_ALPHA, GL_TEXTURE0, GL_CONSTANT, GL_CONSTANT);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_OPERAND_RGB, GL_SRC_COLOR, GL_SRC_COLOR, GL_SRC_COLOR);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_OPERAND_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA);
+		SetUniform1i(PROGRAM_UNIFORM_TEXENV2_COMBINE_RGB, GL_REPLACE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXENV2_COMBINE_ALPHA, GL_REPLACE);
 	}
 
 	void DecalTextureProgram::SetTextureId(const GLuint textureId) { m_TextureId = textureId; }
 
-	void DecalTextureProgram::Update(void) { glBindTexture(GL_TEXTURE_2D, m_TextureId); }
+	void DecalTextureProgram::Update(void)
+	{
+		if (GetGLStateCache().BindTexture2d(m_TextureId))
+		{
+			GetCurrentDrawStatistics().m_TextureBindNum += 1;
+		}
+	}
 
 	void DecalTextureProgram::InitializeVertexAttributes(void)
 	{
@@ -0,0 +1,160 @@
+#include "graphics/graphics_DirtyRegion.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		const u32 DIRTY_REGION_HASH_PRIME = 16777619U;
+
+		s32 ClampCoordinate(const f32 coordinate, const s32 maxCoordinate)
+		{
+			if (coordinate < 0.0f)
+			{
+				return 0;
+			}
+			else if (coordinate > static_cast<f32>(maxCoordinate))
+			{
+				return maxCoordinate;
+			}
+
+			return static_cast<s32>(coordinate);
+		}
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>DirtyRegion</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	DirtyRegion::DirtyRegion(void)
+	: m_WindowWidth(0)
+	, m_WindowHeight(0)
+	, m_TileWidth(1)
+	, m_TileHeight(1)
+	, m_InvalidFlag(true)
+	{
+		for (u32 tileIndex = 0; tileIndex < DIRTY_REGION_TILE_NUM; tileIndex++)
+		{
+			m_TileHashArray[tileIndex]		   = DIRTY_REGION_HASH_SEED;
+			m_PreviousTileHashArray[tileIndex] = DIRTY_REGION_HASH_SEED;
+		}
+	}
+
+	DirtyRegion::~DirtyRegion(void) {}
+
+	void DirtyRegion::SetWindowSize(const s32 windowWidth, const s32 windowHeight)
+	{
+		if ((windowWidth == m_WindowWidth) && (windowHeight == m_WindowHeight))
+		{
+			return;
+		}
+
+		m_WindowWidth  = windowWidth;
+		m_WindowHeight = windowHeight;
+		m_TileWidth	   = (windowWidth + DIRTY_REGION_TILE_COLUMN_NUM - 1) / DIRTY_REGION_TILE_COLUMN_NUM;
+		m_TileHeight   = (windowHeight + DIRTY_REGION_TILE_ROW_NUM - 1) / DIRTY_REGION_TILE_ROW_NUM;
+		if (m_TileWidth < 1)
+		{
+			m_TileWidth = 1;
+		}
+		if (m_TileHeight < 1)
+		{
+			m_TileHeight = 1;
+		}
+
+		m_InvalidFlag = true;
+	}
+
+	void DirtyRegion::Invalidate(void) { m_InvalidFlag = true; }
+
+	void DirtyRegion::Add(const f32 minWindowCoordinateX,
+						  const f32 minWindowCoordinateY,
+						  const f32 maxWindowCoordinateX,
+						  const f32 maxWindowCoordinateY,
+						  const u32 hash)
+	{
+		// The same conversion as RenderData::GetNormalizedDeviceCoordinateXY: the window y-axis becomes the reversed x-axis of the
+		// viewport and the window x-axis its reversed y-axis.
+		s32 minX = ClampCoordinate(static_cast<f32>(m_WindowWidth) - maxWindowCoordinateY, m_WindowWidth);
+		s32 maxX = ClampCoordinate(static_cast<f32>(m_WindowWidth) - minWindowCoordinateY + 1.0f, m_WindowWidth);
+		s32 minY = ClampCoordinate(static_cast<f32>(m_WindowHeight) - maxWindowCoordinateX, m_WindowHeight);
+		s32 maxY = ClampCoordinate(static_cast<f32>(m_WindowHeight) - minWindowCoordinateX + 1.0f, m_WindowHeight);
+		if ((minX >= maxX) || (minY >= maxY))
+		{
+			return;
+		}
+
+		AddTiles(minX / m_TileWidth, minY / m_TileHeight, (maxX - 1) / m_TileWidth, (maxY - 1) / m_TileHeight, hash);
+	}
+
+	void DirtyRegion::AddAll(const u32 hash)
+	{
+		AddTiles(0, 0, DIRTY_REGION_TILE_COLUMN_NUM - 1, DIRTY_REGION_TILE_ROW_NUM - 1, hash);
+	}
+
+	void DirtyRegion::AddTiles(const s32 firstColumn, const s32 firstRow, const s32 lastColumn, const s32 lastRow, const u32 hash)
+	{
+		for (s32 row = firstRow; (row <= lastRow) && (row < static_cast<s32>(DIRTY_REGION_TILE_ROW_NUM)); row++)
+		{
+			for (s32 column = firstColumn; (column <= lastColumn) && (column < static_cast<s32>(DIRTY_REGION_TILE_COLUMN_NUM)); column++)
+			{
+				u32& tileHash = m_TileHashArray[row * DIRTY_REGION_TILE_COLUMN_NUM + column];
+				tileHash	  = Hash(tileHash, &hash, sizeof(hash));
+			}
+		}
+	}
+
+	bool DirtyRegion::EndFrame(GLint& x, GLint& y, GLsizei& width, GLsizei& height)
+	{
+		s32 firstColumn = DIRTY_REGION_TILE_COLUMN_NUM;
+		s32 firstRow	= DIRTY_REGION_TILE_ROW_NUM;
+		s32 lastColumn	= -1;
+		s32 lastRow		= -1;
+
+		for (s32 row = 0; row < static_cast<s32>(DIRTY_REGION_TILE_ROW_NUM); row++)
+		{
+			for (s32 column = 0; column < static_cast<s32>(DIRTY_REGION_TILE_COLUMN_NUM); column++)
+			{
+				u32 tileIndex = row * DIRTY_REGION_TILE_COLUMN_NUM + column;
+				if (m_InvalidFlag || (m_TileHashArray[tileIndex] != m_PreviousTileHashArray[tileIndex]))
+				{
+					firstColumn = (column < firstColumn) ? column : firstColumn;
+					firstRow	= (row < firstRow) ? row : firstRow;
+					lastColumn	= (column > lastColumn) ? column : lastColumn;
+					lastRow		= (row > lastRow) ? row : lastRow;
+				}
+
+				m_PreviousTileHashArray[tileIndex] = m_TileHashArray[tileIndex];
+				m_TileHashArray[tileIndex]		   = DIRTY_REGION_HASH_SEED;
+			}
+		}
+
+		m_InvalidFlag = false;
+
+		if (lastColumn < 0)
+		{
+			return false;
+		}
+
+		s32 maxX = (lastColumn + 1) * m_TileWidth;
+		s32 maxY = (lastRow + 1) * m_TileHeight;
+		x		 = firstColumn * m_TileWidth;
+		y		 = firstRow * m_TileHeight;
+		width	 = ((maxX < m_WindowWidth) ? maxX : m_WindowWidth) - x;
+		height	 = ((maxY < m_WindowHeight) ? maxY : m_WindowHeight) - y;
+
+		return true;
+	}
+
+	u32 DirtyRegion::Hash(const u32 hash, const void* pData, const size_t size)
+	{
+		// FNV-1a, one byte at a time.
+		const u8* pByteArray = static_cast<const u8*>(pData);
+		u32		  result	 = hash;
+		for (size_t byteIndex = 0; byteIndex < size; byteIndex++)
+		{
+			result = (result ^ pByteArray[byteIndex]) * DIRTY_REGION_HASH_PRIME;
+		}
+
+		return result;
+	}
+
+}}	// namespace nn::graphics
@@ -77,6 +77,11 @@ namespace nn { namespace graphics {
 	{
 		if (!m_InitializeFlag)
 		{
+			if ((displayBufferDesc.m_DisplayBufferNum == 0) || (displayBufferDesc.m_DisplayBufferNum > GRAPHICS_MAX_DISPLAY_BUFFER_NUM))
+			{
+				NN_TPANIC_("m_DisplayBufferNum(%d) must be 1 to %d.\n", displayBufferDesc.m_DisplayBufferNum, GRAPHICS_MAX_DISPLAY_BUFFER_NUM);
+			}
+
 			m_TargetDisplay = displayBufferDesc.m_TargetDisplay;
 
 			m_DisplayBufferNum = displayBufferDesc.m_DisplayBufferNum;
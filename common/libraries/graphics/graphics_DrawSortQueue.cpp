@@ -0,0 +1,208 @@
+#include "graphics/graphics_DrawSortQueue.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		// The layer is the upper byte of a key. The lower byte is the batch, or the blend bit for blended batches, which sorts them
+		// after the opaque batches of the layer.
+		const u32 DRAW_SORT_KEY_LAYER_SHIFT = 8;
+		const u32 DRAW_SORT_KEY_BLEND		= 0x80;
+		const u32 DRAW_SORT_RADIX_BITS		= 8;
+		const u32 DRAW_SORT_RADIX_MASK		= DRAW_SORT_RADIX_NUM - 1;
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>DrawSortQueue</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	DrawSortQueue::DrawSortQueue(void)
+	: m_pEntryArray(NULL)
+	, m_pWorkEntryArray(NULL)
+	, m_pSortedEntryArray(NULL)
+	, m_MaxEntriesNum(0)
+	, m_EntriesNum(0)
+	, m_Layer(0)
+	{
+		for (u32 batchIndex = 0; batchIndex < MAX_DRAW_SORT_BATCH_NUM; batchIndex++)
+		{
+			m_BatchArray[batchIndex].m_pRenderData	  = NULL;
+			m_BatchArray[batchIndex].m_ProgramId	  = 0;
+			m_BatchArray[batchIndex].m_TextureId	  = 0;
+			m_BatchArray[batchIndex].m_UseTextureFlag = false;
+			m_BatchArray[batchIndex].m_BlendFlag	  = false;
+		}
+	}
+
+	DrawSortQueue::~DrawSortQueue(void) { Finalize(); }
+
+	void DrawSortQueue::Initialize(const u32 maxEntriesNum)
+	{
+		if (m_pEntryArray != NULL)
+		{
+			return;
+		}
+
+		u32 arraySize	  = maxEntriesNum * sizeof(DrawSortEntry);
+		m_pEntryArray	  = static_cast<DrawSortEntry*>(graphics::Alloc(arraySize));
+		m_pWorkEntryArray = static_cast<DrawSortEntry*>(graphics::Alloc(arraySize));
+		if ((m_pEntryArray == NULL) || (m_pWorkEntryArray == NULL))
+		{
+			NN_TPANIC_("DrawSortQueue::Initialize() : Cannot allocate %d entries.\n", maxEntriesNum);
+		}
+
+		m_pSortedEntryArray = m_pEntryArray;
+		m_MaxEntriesNum		= maxEntriesNum;
+		m_EntriesNum		= 0;
+		m_Layer				= 0;
+	}
+
+	void DrawSortQueue::Finalize(void)
+	{
+		if (m_pEntryArray != NULL)
+		{
+			graphics::Free(m_pEntryArray);
+			m_pEntryArray = NULL;
+		}
+
+		if (m_pWorkEntryArray != NULL)
+		{
+			graphics::Free(m_pWorkEntryArray);
+			m_pWorkEntryArray = NULL;
+		}
+
+		m_pSortedEntryArray = NULL;
+		m_MaxEntriesNum		= 0;
+		m_EntriesNum		= 0;
+	}
+
+	void DrawSortQueue::SetBatch(const u32 batchIndex, TrianglesRenderData* pRenderData, const u32 programId, const bool blendFlag)
+	{
+		if (!(batchIndex < MAX_DRAW_SORT_BATCH_NUM))
+		{
+			NN_TPANIC_("batchIndex(%d) must be < MAX_DRAW_SORT_BATCH_NUM(%d).\n", batchIndex, MAX_DRAW_SORT_BATCH_NUM);
+		}
+
+		m_BatchArray[batchIndex].m_pRenderData = pRenderData;
+		m_BatchArray[batchIndex].m_ProgramId   = programId;
+		m_BatchArray[batchIndex].m_BlendFlag   = blendFlag;
+	}
+
+	void DrawSortQueue::SetBatchTexture(const u32 batchIndex, const GLuint textureId)
+	{
+		if (!(batchIndex < MAX_DRAW_SORT_BATCH_NUM))
+		{
+			NN_TPANIC_("batchIndex(%d) must be < MAX_DRAW_SORT_BATCH_NUM(%d).\n", batchIndex, MAX_DRAW_SORT_BATCH_NUM);
+		}
+
+		m_BatchArray[batchIndex].m_TextureId	  = textureId;
+		m_BatchArray[batchIndex].m_UseTextureFlag = true;
+	}
+
+	const DrawSortBatch& DrawSortQueue::GetBatch(const u32 batchIndex) const { return m_BatchArray[batchIndex]; }
+
+	void DrawSortQueue::SetLayer(const u32 layer)
+	{
+		if (!(layer < MAX_DRAW_SORT_LAYER_NUM))
+		{
+			NN_TPANIC_("layer(%d) must be < MAX_DRAW_SORT_LAYER_NUM(%d).\n", layer, MAX_DRAW_SORT_LAYER_NUM);
+		}
+
+		m_Layer = layer;
+	}
+
+	u32 DrawSortQueue::GetLayer(void) const { return m_Layer; }
+
+	bool DrawSortQueue::Add(const u32 batchIndex, const u32 firstIndex, const u32 indicesNum)
+	{
+		u32 key = m_Layer << DRAW_SORT_KEY_LAYER_SHIFT;
+		key |= m_BatchArray[batchIndex].m_BlendFlag ? DRAW_SORT_KEY_BLEND : batchIndex;
+
+		// A primitive that follows the last one in the same batch and layer extends its entry.
+		if (m_EntriesNum != 0)
+		{
+			DrawSortEntry& lastEntry = m_pEntryArray[m_EntriesNum - 1];
+			if ((lastEntry.m_BatchIndex == batchIndex) && (lastEntry.m_Key == key) &&
+				(lastEntry.m_FirstIndex + lastEntry.m_IndicesNum == firstIndex))
+			{
+				lastEntry.m_IndicesNum += indicesNum;
+				return true;
+			}
+		}
+
+		if (m_EntriesNum >= m_MaxEntriesNum)
+		{
+			return false;
+		}
+
+		DrawSortEntry& entry = m_pEntryArray[m_EntriesNum];
+		entry.m_Key			 = static_cast<u16>(key);
+		entry.m_BatchIndex	 = static_cast<u8>(batchIndex);
+		entry.m_FirstIndex	 = firstIndex;
+		entry.m_IndicesNum	 = indicesNum;
+		m_EntriesNum += 1;
+
+		return true;
+	}
+
+	void DrawSortQueue::Sort(const bool submissionOrderFlag)
+	{
+		DrawSortEntry* pSourceArray		 = m_pEntryArray;
+		DrawSortEntry* pDestinationArray = m_pWorkEntryArray;
+
+		// Least significant digit first. Each pass is stable, so equal keys keep the order they were added in. Skipping the pass of
+		// the batches leaves the entries of each layer in that order.
+		u32 firstShift = submissionOrderFlag ? DRAW_SORT_KEY_LAYER_SHIFT : 0;
+		for (u32 shift = firstShift; shift < DRAW_SORT_KEY_BITS; shift += DRAW_SORT_RADIX_BITS)
+		{
+			u32 offsetArray[DRAW_SORT_RADIX_NUM];
+			for (u32 radix = 0; radix < DRAW_SORT_RADIX_NUM; radix++)
+			{
+				offsetArray[radix] = 0;
+			}
+
+			for (u32 entryIndex = 0; entryIndex < m_EntriesNum; entryIndex++)
+			{
+				offsetArray[(pSourceArray[entryIndex].m_Key >> shift) & DRAW_SORT_RADIX_MASK] += 1;
+			}
+
+			// A digit shared by all the keys, such as the layer when only one is used, leaves the order as it is.
+			if ((m_EntriesNum == 0) || (offsetArray[(pSourceArray[0].m_Key >> shift) & DRAW_SORT_RADIX_MASK] == m_EntriesNum))
+			{
+				continue;
+			}
+
+			u32 offset = 0;
+			for (u32 radix = 0; radix < DRAW_SORT_RADIX_NUM; radix++)
+			{
+				u32 entriesNum	   = offsetArray[radix];
+				offsetArray[radix] = offset;
+				offset += entriesNum;
+			}
+
+			for (u32 entryIndex = 0; entryIndex < m_EntriesNum; entryIndex++)
+			{
+				u32 radix							  = (pSourceArray[entryIndex].m_Key >> shift) & DRAW_SORT_RADIX_MASK;
+				pDestinationArray[offsetArray[radix]] = pSourceArray[entryIndex];
+				offsetArray[radix] += 1;
+			}
+
+			DrawSortEntry* pArray = pSourceArray;
+			pSourceArray		  = pDestinationArray;
+			pDestinationArray	  = pArray;
+		}
+
+		m_pSortedEntryArray = pSourceArray;
+	}
+
+	void DrawSortQueue::Clear(void)
+	{
+		// The sorted entries may be in the work array. New entries are always added to the first one.
+		m_pSortedEntryArray = m_pEntryArray;
+		m_EntriesNum		= 0;
+	}
+
+	u32 DrawSortQueue::GetEntriesNum(void) const { return m_EntriesNum; }
+
+	const DrawSortEntry& DrawSortQueue::GetSortedEntry(const u32 entryIndex) const { return m_pSortedEntryArray[entryIndex]; }
+
+}}	// namespace nn::graphics
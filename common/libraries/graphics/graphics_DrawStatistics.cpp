@@ -0,0 +1,85 @@
+#include "graphics/graphics_DrawStatistics.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		DrawStatistics s_CurrentDrawStatistics;
+		DrawStatistics s_LastDrawStatistics;
+
+		bool IsCounterWithinBudget(const u32 value, const u32 budget) { return (budget == 0) || (value <= budget); }
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>DrawStatistics</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	DrawStatistics::DrawStatistics(void) { Reset(); }
+
+	DrawStatistics::~DrawStatistics(void) {}
+
+	void DrawStatistics::Reset(void)
+	{
+		m_DrawCallNum		   = 0;
+		m_TrianglesNum		   = 0;
+		m_SquaresNum		   = 0;
+		m_TextLength		   = 0;
+		m_TexturedTrianglesNum = 0;
+
+		m_UploadedVertexBytes = 0;
+		m_UploadedIndexBytes  = 0;
+
+		m_ProgramBindNum = 0;
+		m_TextureBindNum = 0;
+
+		m_DroppedTrianglesNum		  = 0;
+		m_DroppedSquaresNum			  = 0;
+		m_DroppedTextLength			  = 0;
+		m_DroppedTexturedTrianglesNum = 0;
+	}
+
+	bool DrawStatistics::IsWithinBudget(const DrawStatistics& budget) const
+	{
+		return IsCounterWithinBudget(m_DrawCallNum, budget.m_DrawCallNum) &&
+			   IsCounterWithinBudget(m_TrianglesNum, budget.m_TrianglesNum) &&
+			   IsCounterWithinBudget(m_SquaresNum, budget.m_SquaresNum) &&
+			   IsCounterWithinBudget(m_TextLength, budget.m_TextLength) &&
+			   IsCounterWithinBudget(m_TexturedTrianglesNum, budget.m_TexturedTrianglesNum) &&
+			   IsCounterWithinBudget(m_UploadedVertexBytes, budget.m_UploadedVertexBytes) &&
+			   IsCounterWithinBudget(m_UploadedIndexBytes, budget.m_UploadedIndexBytes) &&
+			   IsCounterWithinBudget(m_ProgramBindNum, budget.m_ProgramBindNum) &&
+			   IsCounterWithinBudget(m_TextureBindNum, budget.m_TextureBindNum) &&
+			   IsCounterWithinBudget(m_DroppedTrianglesNum, budget.m_DroppedTrianglesNum) &&
+			   IsCounterWithinBudget(m_DroppedSquaresNum, budget.m_DroppedSquaresNum) &&
+			   IsCounterWithinBudget(m_DroppedTextLength, budget.m_DroppedTextLength) &&
+			   IsCounterWithinBudget(m_DroppedTexturedTrianglesNum, budget.m_DroppedTexturedTrianglesNum);
+	}
+
+	void DrawStatistics::Print(void) const
+	{
+		NN_LOG("DrawStatistics\n");
+		NN_LOG("  drawCallNum = %d\n", m_DrawCallNum);
+		NN_LOG("  triangles = %d, squares = %d, textLength = %d, texturedTriangles = %d\n",
+			   m_TrianglesNum,
+			   m_SquaresNum,
+			   m_TextLength,
+			   m_TexturedTrianglesNum);
+		NN_LOG("  uploadedVertexBytes = %d, uploadedIndexBytes = %d\n", m_UploadedVertexBytes, m_UploadedIndexBytes);
+		NN_LOG("  programBindNum = %d, textureBindNum = %d\n", m_ProgramBindNum, m_TextureBindNum);
+		NN_LOG("  dropped : triangles = %d, squares = %d, textLength = %d, texturedTriangles = %d\n",
+			   m_DroppedTrianglesNum,
+			   m_DroppedSquaresNum,
+			   m_DroppedTextLength,
+			   m_DroppedTexturedTrianglesNum);
+	}
+
+	DrawStatistics& GetCurrentDrawStatistics(void) { return s_CurrentDrawStatistics; }
+
+	const DrawStatistics& GetDrawStatistics(void) { return s_LastDrawStatistics; }
+
+	void SwapDrawStatistics(void)
+	{
+		s_LastDrawStatistics = s_CurrentDrawStatistics;
+		s_CurrentDrawStatistics.Reset();
+	}
+
+}}	// namespace nn::graphics
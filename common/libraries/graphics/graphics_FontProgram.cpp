@@ -1,4 +1,6 @@
 #include "graphics/graphics_FontProgram.h"
+#include "graphics/graphics_DrawStatistics.h"
+#include "graphics/graphics_GLStateCache.h"
 
 namespace nn { namespace graphics {
 
@@ -73,12 +75,8 @@ namespace nn { namespace graphics {
 			m_ProgramId = 0;
 		}
 
-		// Vertex shader.
-		if (m_ShaderIds[0] != 0)
-		{
-			glDeleteShader(m_ShaderIds[0]);
-			m_ShaderIds[0] = 0;
-		}
+		// Vertex shader. It belongs to the shader binary, which the other programs of the binary share.
+		m_ShaderIds[0] = 0;
 
 		if (m_FontTextureId != 0)
 		{
@@ -93,12 +91,13 @@ namespace nn { namespace graphics {
 
 	bool FontProgram::Begin(void)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glBlendEquation(GL_FUNC_ADD);
+		GLStateCache& stateCache = GetGLStateCache();
+		stateCache.SetEnable(GL_BLEND, true);
+		stateCache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		stateCache.BlendEquation(GL_FUNC_ADD);
 
-		glDisable(GL_CULL_FACE);
-		glDisable(GL_COLOR_LOGIC_OP);
+		stateCache.SetEnable(GL_CULL_FACE, false);
+		stateCache.SetEnable(GL_COLOR_LOGIC_OP, false);
 
 		return true;
 	}
@@ -110,6 +109,27 @@ namespace nn { namespace graphics {
 			return false;
 		}
 
+		UseState();
+
+		GLStateCache& stateCache = GetGLStateCache();
+
+		// The filters of the font texture are set once in <tt>InitializeFontTexture</tt>.
+		stateCache.ActiveTexture(GL_TEXTURE0);
+		if (stateCache.BindTexture2d(m_FontTextureId))
+		{
+			GetCurrentDrawStatistics().m_TextureBindNum += 1;
+		}
+
+		// Already set by <tt>Begin</tt>, in which case these are skipped.
+		stateCache.SetEnable(GL_BLEND, true);
+		stateCache.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		stateCache.BlendEquation(GL_FUNC_ADD);
+
+		return true;
+	}
+
+	void FontProgram::SetupState(void)
+	{
 		static bool	   initArrayFlag = false;
 		static GLfloat fontColor[4];
 		if (!initArrayFlag)
@@ -122,43 +142,30 @@ namespace nn { namespace graphics {
 			initArrayFlag = true;
 		}
 
-		glUseProgram(m_ProgramId);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_FontTextureId);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-		UpdateModelViewProjectionMatrix();
+		ProgramObject::SetupState();
 
 		// <tt>uniform</tt> for the reserved fragment shader alpha test.
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_ALPHA_TEST], GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_ALPHA_TEST, GL_FALSE);
 
 		// <tt>uniform</tt> for the reserved fragment shader texture sampler.
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE0_SAMPLER_TYPE], GL_TEXTURE_2D);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE1_SAMPLER_TYPE], GL_FALSE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE2_SAMPLER_TYPE], GL_FALSE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE3_SAMPLER_TYPE], GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE0_SAMPLER_TYPE, GL_TEXTURE_2D);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE1_SAMPLER_TYPE, GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE2_SAMPLER_TYPE, GL_FALSE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXTURE3_SAMPLER_TYPE, GL_FALSE);
 
 		// <tt>uniform</tt> for the reserved fragment shader texture combiner.
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_RGB], GL_TEXTURE0, GL_PRIMARY_COLOR, GL_CONSTANT);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_ALPHA], GL_TEXTURE0, GL_PRIMARY_COLOR, GL_CONSTANT);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_RGB], GL_SRC_COLOR, GL_SRC_COLOR, GL_SRC_COLOR);
-		glUniform3i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_ALPHA], GL_SRC_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_RGB], GL_MODULATE);
-		glUniform1i(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_ALPHA], GL_MODULATE);
-		glUniform4fv(m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_CONST_RGBA], 1, fontColor);
-
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glBlendEquation(GL_FUNC_ADD);
-
-		return true;
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_SRC_RGB, GL_TEXTURE0, GL_PRIMARY_COLOR, GL_CONSTANT);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_SRC_ALPHA, GL_TEXTURE0, GL_PRIMARY_COLOR, GL_CONSTANT);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_OPERAND_RGB, GL_SRC_COLOR, GL_SRC_COLOR, GL_SRC_COLOR);
+		SetUniform3i(PROGRAM_UNIFORM_TEXENV2_OPERAND_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA, GL_SRC_ALPHA);
+		SetUniform1i(PROGRAM_UNIFORM_TEXENV2_COMBINE_RGB, GL_MODULATE);
+		SetUniform1i(PROGRAM_UNIFORM_TEXENV2_COMBINE_ALPHA, GL_MODULATE);
+		SetUniform4fv(PROGRAM_UNIFORM_TEXENV2_CONST_RGBA, fontColor);
 	}
 
 	bool FontProgram::End(void)
 	{
-		glDisable(GL_BLEND);
+		GetGLStateCache().SetEnable(GL_BLEND, false);
 
 		return true;
 	}
@@ -198,6 +205,11 @@ namespace nn { namespace graphics {
 		}
 
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, 64, 128, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, fontBitmap);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+		// The texture binding was changed behind the state cache.
+		GetGLStateCache().Invalidate();
 	}
 
 }}	// namespace nn::graphics
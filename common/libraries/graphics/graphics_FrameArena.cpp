@@ -0,0 +1,141 @@
+#include "graphics/graphics_FrameArena.h"
+#include "graphics/graphics_MemoryManager.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		FrameArena s_FrameArena;
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>FrameArena</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	FrameArena::FrameArena(void)
+	: m_InitializeFlag(false)
+	, m_BufferSize(0)
+	, m_BufferNum(0)
+	, m_BufferIndex(0)
+	, m_UsedSize(0)
+	, m_PeakUsedSize(0)
+	, m_FailedAllocationNum(0)
+	{
+		for (u32 bufferIndex = 0; bufferIndex < GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM; bufferIndex++)
+		{
+			m_BufferAddrArray[bufferIndex] = NULL;
+		}
+	}
+
+	FrameArena::~FrameArena(void) { Finalize(); }
+
+	void FrameArena::Initialize(const size_t bufferSize, const u32 bufferNum)
+	{
+		if (m_InitializeFlag)
+		{
+			return;
+		}
+
+		if ((bufferNum == 0) || (bufferNum > GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM))
+		{
+			NN_TPANIC_("bufferNum(%d) must be 1 to %d.\n", bufferNum, GRAPHICS_FRAME_ARENA_BUFFER_MAX_NUM);
+		}
+
+		m_BufferSize = bufferSize;
+		m_BufferNum	 = bufferNum;
+		for (u32 bufferIndex = 0; bufferIndex < m_BufferNum; bufferIndex++)
+		{
+			m_BufferAddrArray[bufferIndex] = static_cast<u8*>(graphics::Alloc(m_BufferSize));
+			if (m_BufferAddrArray[bufferIndex] == NULL)
+			{
+				NN_TPANIC_("FrameArena::Initialize() : Cannot allocate %d buffers of 0x%X bytes.\n", bufferNum, bufferSize);
+			}
+		}
+
+		m_BufferIndex		  = 0;
+		m_UsedSize			  = 0;
+		m_PeakUsedSize		  = 0;
+		m_FailedAllocationNum = 0;
+
+		m_InitializeFlag = true;
+	}
+
+	void FrameArena::Finalize(void)
+	{
+		if (!m_InitializeFlag)
+		{
+			return;
+		}
+
+		for (u32 bufferIndex = 0; bufferIndex < m_BufferNum; bufferIndex++)
+		{
+			graphics::Free(m_BufferAddrArray[bufferIndex]);
+			m_BufferAddrArray[bufferIndex] = NULL;
+		}
+
+		m_BufferNum		 = 0;
+		m_InitializeFlag = false;
+	}
+
+	void* FrameArena::Allocate(const size_t size, const u32 alignment)
+	{
+		if (!m_InitializeFlag)
+		{
+			return NULL;
+		}
+
+		uptr bufferAddr = reinterpret_cast<uptr>(m_BufferAddrArray[m_BufferIndex]);
+		uptr resultAddr = (bufferAddr + m_UsedSize + (alignment - 1)) & ~static_cast<uptr>(alignment - 1);
+		if (resultAddr + size > bufferAddr + m_BufferSize)
+		{
+			m_FailedAllocationNum++;
+			return NULL;
+		}
+
+		m_UsedSize = (resultAddr + size) - bufferAddr;
+		if (m_UsedSize > m_PeakUsedSize)
+		{
+			m_PeakUsedSize = m_UsedSize;
+		}
+
+		return reinterpret_cast<void*>(resultAddr);
+	}
+
+	void FrameArena::Swap(void)
+	{
+		if (!m_InitializeFlag)
+		{
+			return;
+		}
+
+		m_BufferIndex = (m_BufferIndex + 1) % m_BufferNum;
+		m_UsedSize	  = 0;
+	}
+
+	size_t FrameArena::GetBufferSize(void) const { return m_BufferSize; }
+
+	u32 FrameArena::GetBufferNum(void) const { return m_BufferNum; }
+
+	size_t FrameArena::GetUsedSize(void) const { return m_UsedSize; }
+
+	size_t FrameArena::GetPeakUsedSize(void) const { return m_PeakUsedSize; }
+
+	u32 FrameArena::GetFailedAllocationNum(void) const { return m_FailedAllocationNum; }
+
+	void FrameArena::Print(void) const
+	{
+		NN_LOG("FrameArena\n");
+		NN_LOG("  bufferSize = 0x%X, bufferNum = %d\n", m_BufferSize, m_BufferNum);
+		NN_LOG("  used = 0x%X, peak = 0x%X, failed = %d\n", m_UsedSize, m_PeakUsedSize, m_FailedAllocationNum);
+	}
+
+	void InitializeFrameArena(const size_t bufferSize, const u32 bufferNum) { s_FrameArena.Initialize(bufferSize, bufferNum); }
+
+	void FinalizeFrameArena(void) { s_FrameArena.Finalize(); }
+
+	void* AllocFrame(const size_t size, const u32 alignment) { return s_FrameArena.Allocate(size, alignment); }
+
+	void SwapFrameArena(void) { s_FrameArena.Swap(); }
+
+	FrameArena& GetFrameArena(void) { return s_FrameArena; }
+
+}}	// namespace nn::graphics
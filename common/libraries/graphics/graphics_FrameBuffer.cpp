@@ -1,4 +1,5 @@
 #include "graphics/graphics_FrameBuffer.h"
+#include "graphics/graphics_MemoryManager.h"
 
 namespace nn { namespace graphics {
 
@@ -23,7 +24,7 @@ namespace nn { namespace graphics {
 		renderBufferDesc.m_Format	  = GL_RGBA8_OES;
 		renderBufferDesc.m_Width	  = nn::gx::DISPLAY0_WIDTH;
 		renderBufferDesc.m_Height	  = nn::gx::DISPLAY0_HEIGHT;
-		renderBufferDesc.m_Area		  = NN_GX_MEM_VRAMA;
+		renderBufferDesc.m_Area		  = GRAPHICS_MEMORY_AREA_AUTO;
 		renderBufferDesc.m_Attachment = GL_COLOR_ATTACHMENT0;
 
 		return renderBufferDesc;
@@ -35,7 +36,7 @@ namespace nn { namespace graphics {
 		renderBufferDesc.m_Format	  = GL_DEPTH24_STENCIL8_EXT;
 		renderBufferDesc.m_Width	  = nn::gx::DISPLAY0_WIDTH;
 		renderBufferDesc.m_Height	  = nn::gx::DISPLAY0_HEIGHT;
-		renderBufferDesc.m_Area		  = NN_GX_MEM_VRAMB;
+		renderBufferDesc.m_Area		  = GRAPHICS_MEMORY_AREA_AUTO;
 		renderBufferDesc.m_Attachment = GL_DEPTH_STENCIL_ATTACHMENT;
 
 		return renderBufferDesc;
@@ -47,7 +48,7 @@ namespace nn { namespace graphics {
 		renderBufferDesc.m_Format	  = GL_RGBA8_OES;
 		renderBufferDesc.m_Width	  = nn::gx::DISPLAY1_WIDTH;
 		renderBufferDesc.m_Height	  = nn::gx::DISPLAY1_HEIGHT;
-		renderBufferDesc.m_Area		  = NN_GX_MEM_VRAMA;
+		renderBufferDesc.m_Area		  = GRAPHICS_MEMORY_AREA_AUTO;
 		renderBufferDesc.m_Attachment = GL_COLOR_ATTACHMENT0;
 
 		return renderBufferDesc;
@@ -59,7 +60,7 @@ namespace nn { namespace graphics {
 		renderBufferDesc.m_Format	  = GL_DEPTH24_STENCIL8_EXT;
 		renderBufferDesc.m_Width	  = nn::gx::DISPLAY1_WIDTH;
 		renderBufferDesc.m_Height	  = nn::gx::DISPLAY1_HEIGHT;
-		renderBufferDesc.m_Area		  = NN_GX_MEM_VRAMB;
+		renderBufferDesc.m_Area		  = GRAPHICS_MEMORY_AREA_AUTO;
 		renderBufferDesc.m_Attachment = GL_DEPTH_STENCIL_ATTACHMENT;
 
 		return renderBufferDesc;
@@ -157,13 +158,23 @@ namespace nn { namespace graphics {
 			bool depthBufferAttached		= false;
 			bool stencilBufferAttached		= false;
 
+			// The color buffer and the depth-stencil buffer are accessed together, so they are placed in different VRAM banks.
+			GLenum colorArea		= graphics::GetEmptierVramArea();
+			GLenum depthStencilArea = (colorArea == NN_GX_MEM_VRAMA) ? NN_GX_MEM_VRAMB : NN_GX_MEM_VRAMA;
+
 			for (u32 bufferIndex = 0; bufferIndex < GRAPHICS_RENDER_BUFFER_NUM; bufferIndex++)
 			{
 				const RenderBufferDescription& bufferDesc = frameBufferDesc.m_RenderBufferDescriptionArray[bufferIndex];
 				GLuint&						   bufferId	  = m_RenderBufferIdArray[bufferIndex];
 
+				GLenum area = bufferDesc.m_Area;
+				if (area == GRAPHICS_MEMORY_AREA_AUTO)
+				{
+					area = (bufferDesc.m_Attachment == GL_COLOR_ATTACHMENT0) ? colorArea : depthStencilArea;
+				}
+
 				glBindRenderbuffer(GL_RENDERBUFFER, bufferId);
-				glRenderbufferStorage(GL_RENDERBUFFER | bufferDesc.m_Area, bufferDesc.m_Format, bufferDesc.m_Width, bufferDesc.m_Height);
+				glRenderbufferStorage(GL_RENDERBUFFER | area, bufferDesc.m_Format, bufferDesc.m_Width, bufferDesc.m_Height);
 				m_Width	 = bufferDesc.m_Width;
 				m_Height = bufferDesc.m_Height;
 				GRAPHICS_ASSERT_GL_ERROR();
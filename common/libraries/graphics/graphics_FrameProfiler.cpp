@@ -0,0 +1,248 @@
+#include "graphics/graphics_FrameProfiler.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		s64 ToMicroSeconds(const s64 tick) { return nn::os::Tick(tick).ToTimeSpan().GetMicroSeconds(); }
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>FrameProfiler</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	FrameProfiler::FrameProfiler(void)
+	: m_InitializeFlag(false)
+	, m_EnabledFlag(false)
+	, m_FrameStartedFlag(false)
+	, m_FrameBeginTick(0)
+	, m_SampleIndex(0)
+	, m_SampleNum(0)
+	{
+		Reset();
+	}
+
+	FrameProfiler::~FrameProfiler(void) { Finalize(); }
+
+	void FrameProfiler::Initialize(void)
+	{
+		if (!m_InitializeFlag)
+		{
+			Reset();
+
+			m_InitializeFlag = true;
+		}
+	}
+
+	void FrameProfiler::Finalize(void)
+	{
+		if (m_InitializeFlag)
+		{
+			m_EnabledFlag	 = false;
+			m_InitializeFlag = false;
+		}
+	}
+
+	void FrameProfiler::SetEnabled(const bool flag)
+	{
+		if (flag && !m_EnabledFlag)
+		{
+			// The first frame starts now.
+			m_FrameStartedFlag = false;
+		}
+
+		m_EnabledFlag = flag;
+	}
+
+	bool FrameProfiler::IsEnabled(void) const { return m_EnabledFlag; }
+
+	void FrameProfiler::Begin(const FrameProfilerPhase phase)
+	{
+		if (!m_EnabledFlag)
+		{
+			return;
+		}
+
+		nn::os::Tick currentTick = nn::os::Tick::GetSystemCurrent();
+		if (!m_FrameStartedFlag)
+		{
+			m_FrameBeginTick   = currentTick;
+			m_FrameStartedFlag = true;
+		}
+
+		m_PhaseBeginTickArray[phase] = currentTick;
+	}
+
+	void FrameProfiler::End(const FrameProfilerPhase phase)
+	{
+		if (!m_EnabledFlag || !m_FrameStartedFlag)
+		{
+			return;
+		}
+
+		m_CurrentTickArray[phase] += static_cast<s64>(nn::os::Tick::GetSystemCurrent() - m_PhaseBeginTickArray[phase]);
+	}
+
+	void FrameProfiler::EndFrame(void)
+	{
+		if (!m_EnabledFlag || !m_FrameStartedFlag)
+		{
+			return;
+		}
+
+		nn::os::Tick currentTick = nn::os::Tick::GetSystemCurrent();
+
+		// Whatever is not covered by the measured phases is CPU work of the application and the batching of primitives.
+		s64 frameTick = static_cast<s64>(currentTick - m_FrameBeginTick);
+		s64 batchTick = frameTick;
+		for (u32 phase = FRAME_PROFILER_PHASE_FLUSH; phase < FRAME_PROFILER_PHASE_FRAME; phase++)
+		{
+			batchTick -= m_CurrentTickArray[phase];
+		}
+		m_CurrentTickArray[FRAME_PROFILER_PHASE_BATCH] = (batchTick > 0) ? batchTick : 0;
+		m_CurrentTickArray[FRAME_PROFILER_PHASE_FRAME] = frameTick;
+
+		for (u32 phase = 0; phase < FRAME_PROFILER_PHASE_NUM; phase++)
+		{
+			m_SampleTickArray2d[m_SampleIndex][phase] = m_CurrentTickArray[phase];
+			m_CurrentTickArray[phase]				  = 0;
+		}
+
+		m_SampleIndex = (m_SampleIndex + 1) % GRAPHICS_FRAME_PROFILER_FRAME_NUM;
+		if (m_SampleNum < GRAPHICS_FRAME_PROFILER_FRAME_NUM)
+		{
+			m_SampleNum++;
+		}
+
+		// The next frame starts where this one ends.
+		m_FrameBeginTick = currentTick;
+	}
+
+	void FrameProfiler::Reset(void)
+	{
+		for (u32 phase = 0; phase < FRAME_PROFILER_PHASE_NUM; phase++)
+		{
+			m_PhaseBeginTickArray[phase] = nn::os::Tick(0);
+			m_CurrentTickArray[phase]	 = 0;
+
+			for (u32 sampleIndex = 0; sampleIndex < GRAPHICS_FRAME_PROFILER_FRAME_NUM; sampleIndex++)
+			{
+				m_SampleTickArray2d[sampleIndex][phase] = 0;
+			}
+		}
+
+		m_FrameStartedFlag = false;
+		m_SampleIndex	   = 0;
+		m_SampleNum		   = 0;
+	}
+
+	u32 FrameProfiler::GetFrameNum(void) const { return m_SampleNum; }
+
+	s64 FrameProfiler::GetMinMicroSeconds(const FrameProfilerPhase phase) const
+	{
+		if (m_SampleNum == 0)
+		{
+			return 0;
+		}
+
+		s64 minTick = m_SampleTickArray2d[0][phase];
+		for (u32 sampleIndex = 1; sampleIndex < m_SampleNum; sampleIndex++)
+		{
+			if (m_SampleTickArray2d[sampleIndex][phase] < minTick)
+			{
+				minTick = m_SampleTickArray2d[sampleIndex][phase];
+			}
+		}
+
+		return ToMicroSeconds(minTick);
+	}
+
+	s64 FrameProfiler::GetAverageMicroSeconds(const FrameProfilerPhase phase) const
+	{
+		if (m_SampleNum == 0)
+		{
+			return 0;
+		}
+
+		s64 totalTick = 0;
+		for (u32 sampleIndex = 0; sampleIndex < m_SampleNum; sampleIndex++)
+		{
+			totalTick += m_SampleTickArray2d[sampleIndex][phase];
+		}
+
+		return ToMicroSeconds(totalTick / m_SampleNum);
+	}
+
+	s64 FrameProfiler::GetMaxMicroSeconds(const FrameProfilerPhase phase) const
+	{
+		s64 maxTick = 0;
+		for (u32 sampleIndex = 0; sampleIndex < m_SampleNum; sampleIndex++)
+		{
+			if (m_SampleTickArray2d[sampleIndex][phase] > maxTick)
+			{
+				maxTick = m_SampleTickArray2d[sampleIndex][phase];
+			}
+		}
+
+		return ToMicroSeconds(maxTick);
+	}
+
+	s64 FrameProfiler::GetPercentileMicroSeconds(const FrameProfilerPhase phase, const u32 percent) const
+	{
+		if (m_SampleNum == 0)
+		{
+			return 0;
+		}
+
+		s64 sortedTickArray[GRAPHICS_FRAME_PROFILER_FRAME_NUM];
+		for (u32 i = 0; i < m_SampleNum; i++)
+		{
+			s64 tick = m_SampleTickArray2d[i][phase];
+			u32 j	 = i;
+			for (; (j > 0) && (sortedTickArray[j - 1] > tick); j--)
+			{
+				sortedTickArray[j] = sortedTickArray[j - 1];
+			}
+			sortedTickArray[j] = tick;
+		}
+
+		u32 index = ((m_SampleNum - 1) * ((percent > 100) ? 100 : percent) + 99) / 100;
+		return ToMicroSeconds(sortedTickArray[index]);
+	}
+
+	const char* FrameProfiler::GetPhaseName(const FrameProfilerPhase phase)
+	{
+		switch (phase)
+		{
+			case FRAME_PROFILER_PHASE_BATCH:
+				return "Batch";
+			case FRAME_PROFILER_PHASE_FLUSH:
+				return "Flush";
+			case FRAME_PROFILER_PHASE_SUBMIT:
+				return "Submit";
+			case FRAME_PROFILER_PHASE_GPU_WAIT:
+				return "GPU wait";
+			case FRAME_PROFILER_PHASE_VSYNC_WAIT:
+				return "VSync wait";
+			case FRAME_PROFILER_PHASE_FRAME:
+				return "Frame";
+			default:
+				return "Unknown";
+		}
+	}
+
+	void FrameProfiler::Print(void) const
+	{
+		NN_LOG("FrameProfiler (%d frames, usec)\n", m_SampleNum);
+		for (u32 phase = 0; phase < FRAME_PROFILER_PHASE_NUM; phase++)
+		{
+			FrameProfilerPhase profilerPhase = static_cast<FrameProfilerPhase>(phase);
+			NN_LOG("  %-10s : min = %6lld, avg = %6lld, max = %6lld, p99 = %6lld\n",
+				   GetPhaseName(profilerPhase),
+				   GetMinMicroSeconds(profilerPhase),
+				   GetAverageMicroSeconds(profilerPhase),
+				   GetMaxMicroSeconds(profilerPhase),
+				   GetPercentileMicroSeconds(profilerPhase, 99));
+		}
+	}
+
+}}	// namespace nn::graphics
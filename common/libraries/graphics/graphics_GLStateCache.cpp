@@ -0,0 +1,185 @@
+#include "graphics/graphics_GLStateCache.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		GLStateCache s_GLStateCache;
+
+		// Bits of m_ValidFlags. The enable state of each capability has its own bit from GL_STATE_VALID_ENABLE_SHIFT.
+		const bit32 GL_STATE_VALID_PROGRAM		  = (1 << 0);
+		const bit32 GL_STATE_VALID_ACTIVE_TEXTURE = (1 << 1);
+		const bit32 GL_STATE_VALID_TEXTURE		  = (1 << 2);
+		const bit32 GL_STATE_VALID_FILTER		  = (1 << 3);
+		const bit32 GL_STATE_VALID_BLEND_FUNC	  = (1 << 4);
+		const bit32 GL_STATE_VALID_BLEND_EQUATION = (1 << 5);
+		const u32	GL_STATE_VALID_ENABLE_SHIFT	  = 6;
+
+		const GLenum s_CapabilityArray[GL_STATE_CACHE_CAPABILITY_NUM] = {GL_BLEND, GL_CULL_FACE, GL_COLOR_LOGIC_OP};
+
+		u32 GetCapabilityIndex(const GLenum capability)
+		{
+			u32 capabilityIndex = 0;
+			for (; capabilityIndex < GL_STATE_CACHE_CAPABILITY_NUM; capabilityIndex++)
+			{
+				if (s_CapabilityArray[capabilityIndex] == capability)
+				{
+					break;
+				}
+			}
+
+			return capabilityIndex;
+		}
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>GLStateCache</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	GLStateCache::GLStateCache(void)
+	: m_ValidFlags(0)
+	, m_ProgramId(0)
+	, m_ActiveTexture(GL_TEXTURE0)
+	, m_TextureId(0)
+	, m_FilterTextureId(0)
+	, m_MagFilter(GL_LINEAR)
+	, m_MinFilter(GL_LINEAR)
+	, m_BlendSrcFactor(GL_ONE)
+	, m_BlendDstFactor(GL_ZERO)
+	, m_BlendEquation(GL_FUNC_ADD)
+	{
+		for (u32 capabilityIndex = 0; capabilityIndex < GL_STATE_CACHE_CAPABILITY_NUM; capabilityIndex++)
+		{
+			m_EnableFlagArray[capabilityIndex] = false;
+		}
+	}
+
+	GLStateCache::~GLStateCache(void) {}
+
+	void GLStateCache::Invalidate(void) { m_ValidFlags = 0; }
+
+	bool GLStateCache::UseProgram(const GLuint programId)
+	{
+		if ((m_ValidFlags & GL_STATE_VALID_PROGRAM) && (m_ProgramId == programId))
+		{
+			return false;
+		}
+
+		glUseProgram(programId);
+		m_ProgramId = programId;
+		m_ValidFlags |= GL_STATE_VALID_PROGRAM;
+
+		return true;
+	}
+
+	void GLStateCache::ActiveTexture(const GLenum textureUnit)
+	{
+		if ((m_ValidFlags & GL_STATE_VALID_ACTIVE_TEXTURE) && (m_ActiveTexture == textureUnit))
+		{
+			return;
+		}
+
+		glActiveTexture(textureUnit);
+		m_ActiveTexture = textureUnit;
+		m_ValidFlags |= GL_STATE_VALID_ACTIVE_TEXTURE;
+
+		// The bound texture belongs to the texture unit.
+		m_ValidFlags &= ~GL_STATE_VALID_TEXTURE;
+	}
+
+	bool GLStateCache::BindTexture2d(const GLuint textureId)
+	{
+		// The binding is only known for a known texture unit.
+		if ((m_ValidFlags & GL_STATE_VALID_ACTIVE_TEXTURE) && (m_ValidFlags & GL_STATE_VALID_TEXTURE) && (m_TextureId == textureId))
+		{
+			return false;
+		}
+
+		glBindTexture(GL_TEXTURE_2D, textureId);
+		m_TextureId = textureId;
+		if (m_ValidFlags & GL_STATE_VALID_ACTIVE_TEXTURE)
+		{
+			m_ValidFlags |= GL_STATE_VALID_TEXTURE;
+		}
+
+		return true;
+	}
+
+	void GLStateCache::SetTexture2dFilter(const GLenum magFilter, const GLenum minFilter)
+	{
+		// The filters are state of the texture object, so they are only skipped for the texture they were set on.
+		bool textureKnownFlag = (m_ValidFlags & GL_STATE_VALID_TEXTURE) != 0;
+		if (textureKnownFlag && (m_ValidFlags & GL_STATE_VALID_FILTER) && (m_FilterTextureId == m_TextureId) &&
+			(m_MagFilter == magFilter) && (m_MinFilter == minFilter))
+		{
+			return;
+		}
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+
+		if (textureKnownFlag)
+		{
+			m_FilterTextureId = m_TextureId;
+			m_MagFilter		  = magFilter;
+			m_MinFilter		  = minFilter;
+			m_ValidFlags |= GL_STATE_VALID_FILTER;
+		}
+	}
+
+	void GLStateCache::SetEnable(const GLenum capability, const bool enableFlag)
+	{
+		u32	  capabilityIndex = GetCapabilityIndex(capability);
+		bit32 validFlag		  = 0;
+		if (capabilityIndex < GL_STATE_CACHE_CAPABILITY_NUM)
+		{
+			validFlag = (1 << (GL_STATE_VALID_ENABLE_SHIFT + capabilityIndex));
+			if ((m_ValidFlags & validFlag) && (m_EnableFlagArray[capabilityIndex] == enableFlag))
+			{
+				return;
+			}
+		}
+
+		if (enableFlag)
+		{
+			glEnable(capability);
+		}
+		else
+		{
+			glDisable(capability);
+		}
+
+		if (validFlag != 0)
+		{
+			m_EnableFlagArray[capabilityIndex] = enableFlag;
+			m_ValidFlags |= validFlag;
+		}
+	}
+
+	void GLStateCache::BlendFunc(const GLenum srcFactor, const GLenum dstFactor)
+	{
+		if ((m_ValidFlags & GL_STATE_VALID_BLEND_FUNC) && (m_BlendSrcFactor == srcFactor) && (m_BlendDstFactor == dstFactor))
+		{
+			return;
+		}
+
+		glBlendFunc(srcFactor, dstFactor);
+		m_BlendSrcFactor = srcFactor;
+		m_BlendDstFactor = dstFactor;
+		m_ValidFlags |= GL_STATE_VALID_BLEND_FUNC;
+	}
+
+	void GLStateCache::BlendEquation(const GLenum mode)
+	{
+		if ((m_ValidFlags & GL_STATE_VALID_BLEND_EQUATION) && (m_BlendEquation == mode))
+		{
+			return;
+		}
+
+		glBlendEquation(mode);
+		m_BlendEquation = mode;
+		m_ValidFlags |= GL_STATE_VALID_BLEND_EQUATION;
+	}
+
+	GLStateCache& GetGLStateCache(void) { return s_GLStateCache; }
+
+}}	// namespace nn::graphics
@@ -1,4 +1,5 @@
 #include "graphics/graphics_GraphicsDrawing.h"
+#include "graphics/graphics_DrawStatistics.h"
 
 namespace nn { namespace graphics {
 
@@ -10,6 +11,7 @@ namespace nn { namespace graphics {
 	: m_Depth(1.0f)
 	, m_AutoDepth(true)
 	, m_ShaderManager()
+	, m_DrawSortQueue()
 	, m_InitializeTriangles(false)
 	, m_InitializeSquares(false)
 	, m_InitializeTexts(false)
@@ -19,8 +21,8 @@ namespace nn { namespace graphics {
 	, m_TotalSquaresNum(0)
 	, m_MaxTextLength(graphics::MAX_TEXT_LENGTH)
 	, m_TotalTextLength(0)
-	, m_UseColorFillProgram(false)
-	, m_UseFontProgram(false)
+	, m_ShaderWindowTransformFlag(false)
+	, m_Ordered2dModeFlag(false)
 	, m_PointSize(1.0f)
 	, m_LineWidth(1.0f)
 	, m_FontSize(1.0f)
@@ -36,9 +38,6 @@ namespace nn { namespace graphics {
 		m_InitializeSquares	  = false;
 		m_InitializeTexts	  = false;
 
-		m_UseColorFillProgram = false;
-		m_UseFontProgram	  = false;
-
 		m_Color[0] = 1.0f;
 		m_Color[1] = 0.0f;
 		m_Color[2] = 0.0f;
@@ -59,6 +58,11 @@ namespace nn { namespace graphics {
 		{
 			NN_TPANIC_("GraphicsDrawing::Initialize() : ShaderManager.Initialize() failed.\n");
 		}
+
+		m_DrawSortQueue.Initialize();
+		m_DrawSortQueue.SetBatch(DRAW_SORT_BATCH_TRIANGLES, &m_TrianglesRenderData, graphics::COLOR_FILL_SHADER, false);
+		m_DrawSortQueue.SetBatch(DRAW_SORT_BATCH_SQUARES, &m_SquaresRenderData, graphics::COLOR_FILL_SHADER, false);
+		m_DrawSortQueue.SetBatch(DRAW_SORT_BATCH_TEXTS, &m_TextsRenderData, graphics::FONT_SHADER, true);
 	}
 
 	void GraphicsDrawing::Finalize(void)
@@ -66,6 +70,7 @@ namespace nn { namespace graphics {
 		GRAPHICS_ASSERT_GL_ERROR();
 
 		m_ShaderManager.Finalize();
+		m_DrawSortQueue.Finalize();
 
 		m_TrianglesRenderData.Finalize();
 		m_SquaresRenderData.Finalize();
@@ -196,8 +201,14 @@ namespace nn { namespace graphics {
 		}
 	}
 
+	void GraphicsDrawing::SetLayer(const u32 layer) { m_DrawSortQueue.SetLayer(layer); }
+
+	u32 GraphicsDrawing::GetLayer(void) const { return m_DrawSortQueue.GetLayer(); }
+
 	void GraphicsDrawing::SetPointSize(const f32 pointSize) { m_PointSize = pointSize; }
 
+	f32 GraphicsDrawing::GetPointSize(void) const { return m_PointSize; }
+
 	void GraphicsDrawing::DrawPoint(const f32 windowCoordinateX, const f32 windowCoordinateY)
 	{
 		f32 pointHalfSize = 0.5f * m_PointSize;
@@ -219,6 +230,8 @@ namespace nn { namespace graphics {
 
 	void GraphicsDrawing::SetLineWidth(const f32 lineWidth) { m_LineWidth = lineWidth; }
 
+	f32 GraphicsDrawing::GetLineWidth(void) const { return m_LineWidth; }
+
 	void GraphicsDrawing::DrawLine(const f32 windowCoordinateX0,
 								   const f32 windowCoordinateY0,
 								   const f32 windowCoordinateX1,
@@ -287,15 +300,21 @@ namespace nn { namespace graphics {
 		{
 			NN_TLOG_("GraphicsDrawing::FillSquare() maxSquares limit\n");
 			NN_TLOG_("  squaresIndex = %d, maxSquaresNum = %d\n", m_TotalSquaresNum, m_MaxSquaresNum);
+			GetCurrentDrawStatistics().m_DroppedSquaresNum += 1;
 			return;
 		}
 
-		m_UseColorFillProgram = true;
-
 		graphics::TrianglesRenderData& renderData  = m_SquaresRenderData;
 		u32							   vertexIndex = renderData.GetPackedVerticesNum();
 		u32							   squareIndex = renderData.GetPackedTrianglesNum() / 4;
 
+		// Each quadrangle has six indices in the triangle strip, including those of the degenerate triangles.
+		if (!AddSortedPrimitive(DRAW_SORT_BATCH_SQUARES, 6 * squareIndex, 6))
+		{
+			GetCurrentDrawStatistics().m_DroppedSquaresNum += 1;
+			return;
+		}
+
 		// POSITION 0
 		f32 normalizedDeviceCoordinateX = 0.0f;
 		f32 normalizedDeviceCoordinateY = 0.0f;
@@ -341,6 +360,7 @@ namespace nn { namespace graphics {
 		renderData.AddPackedTrianglesNum(4);
 
 		m_TotalSquaresNum += 1;
+		GetCurrentDrawStatistics().m_SquaresNum += 1;
 
 		GRAPHICS_ASSERT_GL_ERROR();
 	}
@@ -373,13 +393,19 @@ namespace nn { namespace graphics {
 		{
 			NN_TLOG_("GraphicsDrawing::FillTriangle() maxSquares limit\n");
 			NN_TLOG_("  trianglesIndex = %d, maxTrianglesNum = %d\n", m_TotalTrianglesNum, m_MaxTrianglesNum);
+			GetCurrentDrawStatistics().m_DroppedTrianglesNum += 1;
 			return;
 		}
 
-		m_UseColorFillProgram						 = true;
 		graphics::TrianglesRenderData& renderData	 = m_TrianglesRenderData;
 		u32							   triangleIndex = renderData.GetPackedTrianglesNum();
 
+		if (!AddSortedPrimitive(DRAW_SORT_BATCH_TRIANGLES, 3 * triangleIndex, 3))
+		{
+			GetCurrentDrawStatistics().m_DroppedTrianglesNum += 1;
+			return;
+		}
+
 		// POSITION 0
 		f32 normalizedDeviceCoordinateX = 0.0f;
 		f32 normalizedDeviceCoordinateY = 0.0f;
@@ -418,6 +444,7 @@ namespace nn { namespace graphics {
 		renderData.AddPackedTrianglesNum(1);
 
 		m_TotalTrianglesNum += 1;
+		GetCurrentDrawStatistics().m_TrianglesNum += 1;
 
 		GRAPHICS_ASSERT_GL_ERROR();
 	}
@@ -428,6 +455,8 @@ namespace nn { namespace graphics {
 		m_TextsRenderData.SetFontSize(m_FontSize);
 	}
 
+	f32 GraphicsDrawing::GetFontSize(void) const { return m_FontSize; }
+
 	void GraphicsDrawing::DrawText(const f32 windowCoordinateX, const f32 windowCoordinateY, const char* format, ...)
 	{
 		static const u32 tmpBufferSize = 1024;
@@ -481,15 +510,22 @@ namespace nn { namespace graphics {
 		{
 			NN_TLOG_("GraphicsDrawing::DrawText() maxText limit\n");
 			NN_TLOG_("  textLength = %d, maxTextLength = %d, totalTextLength = %d\n", textLength, m_MaxTextLength, m_TotalTextLength);
+			GetCurrentDrawStatistics().m_DroppedTextLength += textLength;
 			return;
 		}
 
-		m_UseFontProgram = true;
+		// Each character has two triangles.
+		if (!AddSortedPrimitive(DRAW_SORT_BATCH_TEXTS, 6 * renderData.GetPackedTextLength(), 6 * textLength))
+		{
+			GetCurrentDrawStatistics().m_DroppedTextLength += textLength;
+			return;
+		}
 
 		m_TextsRenderData.SetFontColor(m_Color[0], m_Color[1], m_Color[2], m_Color[3]);
 		renderData.AddText(windowCoordinateX, windowCoordinateY, textBuffer, textLength, m_Depth);
 
 		m_TotalTextLength += textLength;
+		GetCurrentDrawStatistics().m_TextLength += textLength;
 
 		DecrementDepth();
 
@@ -498,59 +534,214 @@ namespace nn { namespace graphics {
 
 	void GraphicsDrawing::Flush(void)
 	{
-		FlushColorFillPrimitives();
-		FlushTexts();
+		FlushSortedPrimitives();
 
 		m_Depth = 1.0f;
 		DecrementDepth();
 	}
 
-	void GraphicsDrawing::FlushColorFillPrimitives(void)
+	void GraphicsDrawing::DiscardPrimitives(void)
 	{
-		if (!m_UseColorFillProgram)
+		for (u32 batchIndex = 0; batchIndex < graphics::MAX_DRAW_SORT_BATCH_NUM; batchIndex++)
 		{
-			return;
+			graphics::TrianglesRenderData* pRenderData = m_DrawSortQueue.GetBatch(batchIndex).m_pRenderData;
+			if (pRenderData != NULL)
+			{
+				pRenderData->ClearPackedNum();
+			}
 		}
 
-		graphics::ProgramObject* shaderProgramPtr = m_ShaderManager.GetShaderProgram(graphics::COLOR_FILL_SHADER);
-		shaderProgramPtr->SetUse3d(false);
-		shaderProgramPtr->Begin();
-		shaderProgramPtr->Use();
+		ClearSortedPrimitives();
 
-		m_TrianglesRenderData.DrawPackedTriangles();
-		m_SquaresRenderData.DrawPackedTriangles();
+		m_Depth = 1.0f;
+		DecrementDepth();
+	}
 
-		m_TotalTrianglesNum = 0;
-		m_TotalSquaresNum	= 0;
+	void GraphicsDrawing::TrimRenderDataArrays(void)
+	{
+		m_TrianglesRenderData.TrimArrays();
+		m_SquaresRenderData.TrimArrays();
+		m_TextsRenderData.TrimArrays();
+	}
 
-		shaderProgramPtr->End();
+	void GraphicsDrawing::SetVertexBufferRingNum(const u32 bufferRingNum)
+	{
+		m_TrianglesRenderData.SetVertexBufferRingNum(bufferRingNum);
+		m_SquaresRenderData.SetVertexBufferRingNum(bufferRingNum);
+		m_TextsRenderData.SetVertexBufferRingNum(bufferRingNum);
+	}
 
-		m_UseColorFillProgram = false;
+	void GraphicsDrawing::SetDirectVertexBuffer(const bool directFlag)
+	{
+		m_TrianglesRenderData.SetDirectVertexBuffer(directFlag);
+		m_SquaresRenderData.SetDirectVertexBuffer(directFlag);
+		m_TextsRenderData.SetDirectVertexBuffer(directFlag);
+	}
 
-		GRAPHICS_ASSERT_GL_ERROR();
+	void GraphicsDrawing::SetShaderWindowTransform(const bool shaderFlag)
+	{
+		m_ShaderWindowTransformFlag = shaderFlag;
+
+		m_TrianglesRenderData.SetShaderWindowTransform(shaderFlag);
+		m_SquaresRenderData.SetShaderWindowTransform(shaderFlag);
+		m_TextsRenderData.SetShaderWindowTransform(shaderFlag);
 	}
 
-	void GraphicsDrawing::FlushTexts(void)
+	void GraphicsDrawing::SetOrdered2dMode(const bool orderedFlag) { m_Ordered2dModeFlag = orderedFlag; }
+
+	void GraphicsDrawing::SetWindowTransform(graphics::ProgramObject* shaderProgramPtr)
 	{
-		if (!m_UseFontProgram)
+		if (!m_ShaderWindowTransformFlag)
 		{
+			// The vertices are already in normalized device coordinates.
+			shaderProgramPtr->SetUse3d(false);
 			return;
 		}
 
-		graphics::ProgramObject* shaderProgramPtr = m_ShaderManager.GetShaderProgram(graphics::FONT_SHADER);
-		shaderProgramPtr->SetUse3d(false);
-		shaderProgramPtr->Begin();
-		shaderProgramPtr->Use();
+		// Only the projection matrix depends on the window size, so changing it sets one uniform.
+		nn::math::MTX44 projectionMatrix;
+		nn::math::MTX44 modelViewMatrix;
+		graphics::GetWindowProjectionMatrix(m_WindowWidth, m_WindowHeight, projectionMatrix);
+		MTX44Identity(&modelViewMatrix);
 
-		m_TextsRenderData.DrawPackedTriangles();
-		m_TextsRenderData.ClearPackedTextLength();
-		m_TotalTextLength = 0;
+		shaderProgramPtr->SetProjectionMatrix(projectionMatrix);
+		shaderProgramPtr->SetModelViewMatrix(modelViewMatrix);
+		shaderProgramPtr->SetUse3d(true);
+	}
+
+	bool GraphicsDrawing::AddSortedPrimitive(const u32 batchIndex, const u32 firstIndex, const u32 indicesNum)
+	{
+		if (!m_DrawSortQueue.Add(batchIndex, firstIndex, indicesNum))
+		{
+			NN_TLOG_("GraphicsDrawing::AddSortedPrimitive() maxEntries limit\n");
+			NN_TLOG_("  entriesNum = %d\n", m_DrawSortQueue.GetEntriesNum());
+			return false;
+		}
+
+		return true;
+	}
 
-		shaderProgramPtr->End();
+	void GraphicsDrawing::FlushSortedPrimitives(void)
+	{
+		u32 entriesNum = m_DrawSortQueue.GetEntriesNum();
+		if (entriesNum != 0)
+		{
+			m_DrawSortQueue.Sort(m_Ordered2dModeFlag);
 
-		m_UseFontProgram = false;
+			// The order of the draws alone decides what is on top, so the depth buffer is neither tested nor written. The state of
+			// the application is restored afterwards.
+			GLboolean depthTestFlag = GL_FALSE;
+			GLboolean depthMaskFlag = GL_TRUE;
+			if (m_Ordered2dModeFlag)
+			{
+				depthTestFlag = glIsEnabled(GL_DEPTH_TEST);
+				glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMaskFlag);
+				glDisable(GL_DEPTH_TEST);
+				glDepthMask(GL_FALSE);
+			}
+
+			for (u32 batchIndex = 0; batchIndex < graphics::MAX_DRAW_SORT_BATCH_NUM; batchIndex++)
+			{
+				graphics::TrianglesRenderData* pRenderData = m_DrawSortQueue.GetBatch(batchIndex).m_pRenderData;
+				if (pRenderData != NULL)
+				{
+					pRenderData->BeginPackedDraw();
+				}
+			}
+
+			graphics::ProgramObject* shaderProgramPtr = NULL;
+			u32						 programId		  = 0;
+			GLuint					 textureId		  = 0;
+
+			u32 entryIndex = 0;
+			while (entryIndex < entriesNum)
+			{
+				const graphics::DrawSortEntry& entry	  = m_DrawSortQueue.GetSortedEntry(entryIndex);
+				u32							   indicesNum = entry.m_IndicesNum;
+				entryIndex += 1;
+
+				// The entries of a batch that the sort put next to each other are drawn at once when their ranges follow each other.
+				while (entryIndex < entriesNum)
+				{
+					const graphics::DrawSortEntry& nextEntry = m_DrawSortQueue.GetSortedEntry(entryIndex);
+					if ((nextEntry.m_BatchIndex != entry.m_BatchIndex) || (nextEntry.m_FirstIndex != entry.m_FirstIndex + indicesNum))
+					{
+						break;
+					}
+
+					indicesNum += nextEntry.m_IndicesNum;
+					entryIndex += 1;
+				}
+
+				const graphics::DrawSortBatch& batch = m_DrawSortQueue.GetBatch(entry.m_BatchIndex);
+				if ((batch.m_pRenderData == NULL) || (batch.m_UseTextureFlag && (batch.m_TextureId == 0)))
+				{
+					continue;
+				}
+
+				if ((shaderProgramPtr == NULL) || (batch.m_ProgramId != programId))
+				{
+					if (shaderProgramPtr != NULL)
+					{
+						shaderProgramPtr->End();
+					}
+
+					programId		 = batch.m_ProgramId;
+					shaderProgramPtr = m_ShaderManager.GetShaderProgram(programId);
+					SetWindowTransform(shaderProgramPtr);
+					shaderProgramPtr->Begin();
+					shaderProgramPtr->Use();
+					textureId = 0;
+				}
+
+				if (batch.m_UseTextureFlag && (batch.m_TextureId != textureId))
+				{
+					textureId = batch.m_TextureId;
+					shaderProgramPtr->SetTextureId(textureId);
+					shaderProgramPtr->Update();
+				}
+
+				batch.m_pRenderData->DrawPackedRange(entry.m_FirstIndex, indicesNum);
+			}
+
+			if (shaderProgramPtr != NULL)
+			{
+				shaderProgramPtr->End();
+			}
+
+			if (m_Ordered2dModeFlag)
+			{
+				if (depthTestFlag)
+				{
+					glEnable(GL_DEPTH_TEST);
+				}
+				glDepthMask(depthMaskFlag);
+			}
+
+			for (u32 batchIndex = 0; batchIndex < graphics::MAX_DRAW_SORT_BATCH_NUM; batchIndex++)
+			{
+				graphics::TrianglesRenderData* pRenderData = m_DrawSortQueue.GetBatch(batchIndex).m_pRenderData;
+				if (pRenderData != NULL)
+				{
+					pRenderData->EndPackedDraw();
+				}
+			}
+		}
+
+		ClearSortedPrimitives();
 
 		GRAPHICS_ASSERT_GL_ERROR();
 	}
 
+	void GraphicsDrawing::ClearSortedPrimitives(void)
+	{
+		m_DrawSortQueue.Clear();
+		m_DrawSortQueue.SetLayer(0);
+
+		m_TextsRenderData.ClearPackedTextLength();
+		m_TotalTrianglesNum = 0;
+		m_TotalSquaresNum	= 0;
+		m_TotalTextLength	= 0;
+	}
+
 }}	// namespace nn::graphics
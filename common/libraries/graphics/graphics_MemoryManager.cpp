@@ -1,4 +1,5 @@
 ﻿#include <nn/gx/CTR/gx_CommandAccess.h>
+#include <nn/os/os_Thread.h>
 
 #include "graphics/graphics_MemoryManager.h"
 
@@ -6,23 +7,52 @@
 
 namespace nn { namespace graphics {
 	namespace {
-		inline uptr MathRoundup(uptr x, int base) { return ((x) + ((base)-1)) & ~((base)-1); }
+		// Enters the critical section, if any, for the lifetime of the object.
+		class ScopedAllocatorLock
+		{
+		public:
+			explicit ScopedAllocatorLock(nn::os::CriticalSection* pCriticalSection)
+			: m_pCriticalSection(pCriticalSection)
+			{
+				if (m_pCriticalSection != NULL)
+				{
+					m_pCriticalSection->Enter();
+				}
+			}
+
+			~ScopedAllocatorLock(void)
+			{
+				if (m_pCriticalSection != NULL)
+				{
+					m_pCriticalSection->Leave();
+				}
+			}
+
+		private:
+			nn::os::CriticalSection* m_pCriticalSection;
+		};
 	}  // namespace
 
 	namespace detail {
 		MemoryManager::MemoryManager()
 		: m_Initialized(false)
 		, m_pStartAddrFcram(NULL)
-		, m_CurrentAddrVramA(NULL)
-		, m_CurrentAddrVramB(NULL)
+		, m_VramAllocatorA()
+		, m_VramAllocatorB()
 		, m_HeapOnFcram()
 		, m_AllocatedBlockSize(0)
+		, m_SizeClassPool()
+		, m_pSizeClassPoolRegion(NULL)
+		, m_AllocationRegistry()
+		, m_PlacementPolicy(MEMORY_PLACEMENT_POLICY_BALANCED)
+		, m_FcramFallbackNum(0)
+		, m_ThreadSafeFlag(false)
 		{
 		}
 
 		MemoryManager::~MemoryManager() { Finalize(); }
 
-		void MemoryManager::Initialize(const uptr fcramAddress, const size_t memorySize)
+		void MemoryManager::Initialize(const uptr fcramAddress, const size_t memorySize, const bool threadSafe)
 		{
 			if (m_Initialized)
 			{
@@ -36,13 +66,34 @@ namespace nn { namespace graphics {
 
 			m_HeapOnFcram.Initialize(m_pStartAddrFcram, memorySize);
 
-			m_CurrentAddrVramA = nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMA);
-			m_CurrentAddrVramB = nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMB);
+			// The slabs of the size class pool are carved once from the heap, so small buffers of graphics::Alloc do not fragment it.
+			m_pSizeClassPoolRegion = m_HeapOnFcram.Allocate(SizeClassPool::GetRequiredSize(), 8);
+			if (m_pSizeClassPoolRegion != NULL)
+			{
+				m_SizeClassPool.Initialize(m_pSizeClassPoolRegion, SizeClassPool::GetRequiredSize());
+			}
+			else
+			{
+				NN_TLOG_("[graphics::MemoryManager] No memory for the size class pool. Small buffers are allocated from the heap.\n");
+			}
+
+			m_VramAllocatorA.Initialize(nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMA), nn::gx::GetVramSize(nn::gx::MEM_VRAMA));
+			m_VramAllocatorB.Initialize(nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMB), nn::gx::GetVramSize(nn::gx::MEM_VRAMB));
+			m_FcramFallbackNum = 0;
+			m_AllocationRegistry.Initialize();
+
+			m_ThreadSafeFlag = threadSafe;
+			if (m_ThreadSafeFlag)
+			{
+				m_CriticalSection.Initialize();
+				// The thread that initializes the graphics library is the render thread.
+				m_ThreadCacheArray[0].Bind(nn::os::Thread::GetCurrentId());
+			}
 
 #if DEBUG_PRINT
 			NN_TLOG_("[graphics::MemoryManager] Start address on Main Memory (FCRAM): 0x%08X\n", m_pStartAddrFcram);
-			NN_TLOG_("[graphics::MemoryManager] Start address on VRAM-A: 0x%08X\n", m_CurrentAddrVramA);
-			NN_TLOG_("[graphics::MemoryManager] Start address on VRAM-B: 0x%08X\n", m_CurrentAddrVramB);
+			NN_TLOG_("[graphics::MemoryManager] Start address on VRAM-A: 0x%08X\n", nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMA));
+			NN_TLOG_("[graphics::MemoryManager] Start address on VRAM-B: 0x%08X\n", nn::gx::GetVramStartAddr(nn::gx::MEM_VRAMB));
 #endif
 
 			m_Initialized = true;
@@ -50,25 +101,176 @@ namespace nn { namespace graphics {
 
 		void MemoryManager::Finalize(void)
 		{
+			m_SizeClassPool.Finalize();
+			m_pSizeClassPoolRegion = NULL;
 			m_HeapOnFcram.Finalize();
+			m_VramAllocatorA.Finalize();
+			m_VramAllocatorB.Finalize();
+			m_AllocationRegistry.Finalize();
+
+			if (m_ThreadSafeFlag)
+			{
+				// The cached buffers belong to the size class pool, which has just been finalized.
+				for (u32 cacheIndex = 0; cacheIndex < GRAPHICS_THREAD_CACHE_MAX_NUM; cacheIndex++)
+				{
+					m_ThreadCacheArray[cacheIndex].Unbind();
+				}
+				m_CriticalSection.Finalize();
+				m_ThreadSafeFlag = false;
+			}
 
 			m_Initialized = false;
 		}
 
 		void MemoryManager::PrintFreeMemorySize(void)
 		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+
 			NN_TLOG_("[graphics::MemoryManager] Free memory size on Main Memory (FCRAM) is 0x%06X(max 0x%06X)\n",
 					 m_HeapOnFcram.GetTotalFreeSize(),
 					 m_AllocatedBlockSize);
 			NN_TLOG_("[graphics::MemoryManager] Free memory size on VRAM-A is 0x%06X(max 0x%06X)\n",
-					 nn::gx::GetVramEndAddr(nn::gx::MEM_VRAMA) - m_CurrentAddrVramA,
-					 nn::gx::GetVramSize(nn::gx::MEM_VRAMA));
+					 m_VramAllocatorA.GetFreeSize(),
+					 m_VramAllocatorA.GetTotalSize());
 			NN_TLOG_("[graphics::MemoryManager] Free memory size on VRAM-B is 0x%06X(max 0x%06X)\n",
-					 nn::gx::GetVramEndAddr(nn::gx::MEM_VRAMB) - m_CurrentAddrVramB,
-					 nn::gx::GetVramSize(nn::gx::MEM_VRAMB));
+					 m_VramAllocatorB.GetFreeSize(),
+					 m_VramAllocatorB.GetTotalSize());
+			m_VramAllocatorA.Print("VRAM-A");
+			m_VramAllocatorB.Print("VRAM-B");
+			if (m_FcramFallbackNum > 0)
+			{
+				NN_TLOG_("[graphics::MemoryManager] %d buffers requested in VRAM were placed on Main Memory (FCRAM)\n", m_FcramFallbackNum);
+			}
+
+			MemorySnapshot snapshot;
+			m_AllocationRegistry.GetSnapshot(snapshot);
+			AddPooledBlocks(snapshot);
+			snapshot.Print();
+			m_SizeClassPool.Print();
+
+			for (u32 cacheIndex = 0; cacheIndex < GRAPHICS_THREAD_CACHE_MAX_NUM; cacheIndex++)
+			{
+				const ThreadCache& threadCache = m_ThreadCacheArray[cacheIndex];
+				if (threadCache.IsBound())
+				{
+					NN_TLOG_("[graphics::MemoryManager] Thread cache of thread %d : hit %d, miss %d\n",
+							 threadCache.GetThreadId(),
+							 threadCache.GetHitNum(),
+							 threadCache.GetMissNum());
+				}
+			}
+		}
+
+		void MemoryManager::GetSnapshot(MemorySnapshot& snapshot) const
+		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			m_AllocationRegistry.GetSnapshot(snapshot);
+			AddPooledBlocks(snapshot);
+		}
+
+		void MemoryManager::PrintLiveBlocks(const u32 maxNum, const MemoryBlockSortKey sortKey, const MemorySnapshot* pSince) const
+		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			m_AllocationRegistry.PrintLiveBlocks(maxNum, sortKey, pSince);
+
+			MemorySnapshot pooledSnapshot;
+			AddPooledBlocks(pooledSnapshot);
+			u32 areaIndex = GetMemoryAreaIndex(NN_GX_MEM_FCRAM);
+			u32 aimIndex  = GetMemoryAimIndex(NN_GX_MEM_SYSTEM);
+			NN_TLOG_("[graphics::MemoryManager] Size-class pool : %d blocks, 0x%X bytes in use\n",
+					 pooledSnapshot.m_LiveNumArray2d[areaIndex][aimIndex],
+					 pooledSnapshot.m_LiveSizeArray2d[areaIndex][aimIndex]);
+		}
+
+		void MemoryManager::AddPooledBlocks(MemorySnapshot& snapshot) const
+		{
+			// Pool blocks are not registered one by one, so that the thread caches stay lock-free and the small blocks do not fill
+			// the registry. Blocks held by a thread cache are free. Other threads may change their cache meanwhile, so the count of
+			// a thread-safe memory manager is approximate.
+			u32 areaIndex = GetMemoryAreaIndex(NN_GX_MEM_FCRAM);
+			u32 aimIndex  = GetMemoryAimIndex(NN_GX_MEM_SYSTEM);
+			for (u32 classIndex = 0; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				u32 usedNum = m_SizeClassPool.GetUsedBlockNum(classIndex);
+				if (classIndex < THREAD_CACHE_CLASS_NUM)
+				{
+					for (u32 cacheIndex = 0; cacheIndex < GRAPHICS_THREAD_CACHE_MAX_NUM; cacheIndex++)
+					{
+						u32 cachedNum = m_ThreadCacheArray[cacheIndex].GetBlockNum(classIndex);
+						usedNum		  = (cachedNum < usedNum) ? (usedNum - cachedNum) : 0;
+					}
+				}
+
+				size_t classSize = SizeClassPool::GetClassSize(classIndex);
+				snapshot.m_LiveNumArray2d[areaIndex][aimIndex] += usedNum;
+				snapshot.m_LiveSizeArray2d[areaIndex][aimIndex] += usedNum * classSize;
+				snapshot.m_PeakSizeArray2d[areaIndex][aimIndex] += m_SizeClassPool.GetPeakUsedBlockNum(classIndex) * classSize;
+			}
+		}
+
+		const VramAllocator& MemoryManager::GetVramAllocator(GLenum area) const
+		{
+			if (area == NN_GX_MEM_VRAMB)
+			{
+				return m_VramAllocatorB;
+			}
+
+			return m_VramAllocatorA;
+		}
+
+		GLenum MemoryManager::GetEmptierVramArea(void) const
+		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			return (m_VramAllocatorB.GetFreeSize() > m_VramAllocatorA.GetFreeSize()) ? NN_GX_MEM_VRAMB : NN_GX_MEM_VRAMA;
+		}
+
+		void MemoryManager::SetPlacementPolicy(const MemoryPlacementPolicy policy) { m_PlacementPolicy = policy; }
+
+		MemoryPlacementPolicy MemoryManager::GetPlacementPolicy(void) const { return m_PlacementPolicy; }
+
+		GLenum MemoryManager::SelectArea(GLenum area, GLenum aim, GLsizei size, const u32 addrAlign) const
+		{
+			if ((m_PlacementPolicy == MEMORY_PLACEMENT_POLICY_FIXED) || ((area != NN_GX_MEM_VRAMA) && (area != NN_GX_MEM_VRAMB)))
+			{
+				return area;
+			}
+
+			GLenum otherArea = (area == NN_GX_MEM_VRAMA) ? NN_GX_MEM_VRAMB : NN_GX_MEM_VRAMA;
+
+			// Textures are read by the GPU from either bank at the same cost, so they go where there is the most room.
+			if ((aim == NN_GX_MEM_TEXTURE) && (GetVramAllocator(otherArea).GetFreeSize() > GetVramAllocator(area).GetFreeSize()))
+			{
+				GLenum swapArea = area;
+				area			= otherArea;
+				otherArea		= swapArea;
+			}
+
+			if (GetVramAllocator(area).CanAllocate(size, addrAlign))
+			{
+				return area;
+			}
+			if (GetVramAllocator(otherArea).CanAllocate(size, addrAlign))
+			{
+				return otherArea;
+			}
+
+			// Only textures and vertex buffers can be read from main memory. Color, depth and display buffers must stay in VRAM, so
+			// their allocation fails on the requested bank.
+			if ((aim == NN_GX_MEM_TEXTURE) || (aim == NN_GX_MEM_VERTEXBUFFER))
+			{
+				return NN_GX_MEM_FCRAM;
+			}
+
+			return area;
 		}
 
 		void* MemoryManager::Allocate(GLenum area, GLenum aim, GLuint id, GLsizei size)
+		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			return AllocateImpl(area, aim, id, size);
+		}
+
+		void* MemoryManager::AllocateImpl(GLenum area, GLenum aim, GLuint id, GLsizei size)
 		{
 			if (!m_Initialized)
 			{
@@ -78,11 +280,7 @@ namespace nn { namespace graphics {
 			if (size == 0)
 				return 0;
 
-			// When allocating to VRAM, for simplicity treat VRAM like a stack.
-			// Also, don't worry about fragmentation.
-			// To deal with fragmentation, you may need to retain information about the memory allocated as "area," "aim" and "id" when
-			// allocation is successful so they can be subsequently deallocated.
-			//
+			// Each VRAM bank has its own allocator, which records "aim" and "id" with every block so it can be freed and merged again.
 
 			int	  addrAlign	 = 8;
 			void* resultAddr = NULL;
@@ -118,6 +316,17 @@ namespace nn { namespace graphics {
 					break;
 			}
 
+			GLenum requestedArea = area;
+			area				 = SelectArea(area, aim, size, addrAlign);
+			if ((area == NN_GX_MEM_FCRAM) && (requestedArea != NN_GX_MEM_FCRAM))
+			{
+				NN_TLOG_("[graphics::MemoryManager] Lack of resource on VRAM. (aim 0x%X, id %d, size 0x%X) is placed on Main Memory (FCRAM).\n",
+						 aim,
+						 id,
+						 size);
+				m_FcramFallbackNum++;
+			}
+
 			switch (area)
 			{
 				case NN_GX_MEM_FCRAM:
@@ -133,27 +342,17 @@ namespace nn { namespace graphics {
 					}
 					break;
 				case NN_GX_MEM_VRAMA:
+					if ((resultAddr = m_VramAllocatorA.Allocate(size, addrAlign, aim, id)) == NULL)
 					{
-						if (MathRoundup(m_CurrentAddrVramA, addrAlign) + size > nn::gx::GetVramEndAddr(nn::gx::MEM_VRAMA))
-						{
-							NN_TPANIC_("Lack of resource on VRAM-A.\n");
-						}
-
-						m_CurrentAddrVramA = MathRoundup(m_CurrentAddrVramA, addrAlign);
-						resultAddr		   = reinterpret_cast<void*>(m_CurrentAddrVramA);
-						m_CurrentAddrVramA += size;
+						m_VramAllocatorA.Print("VRAM-A");
+						NN_TPANIC_("Lack of resource on VRAM-A.\n");
 					}
 					break;
 				case NN_GX_MEM_VRAMB:
+					if ((resultAddr = m_VramAllocatorB.Allocate(size, addrAlign, aim, id)) == NULL)
 					{
-						if (MathRoundup(m_CurrentAddrVramB, addrAlign) + size > nn::gx::GetVramEndAddr(nn::gx::MEM_VRAMB))
-						{
-							NN_TPANIC_("Lack of resource on VRAM-B.\n");
-						}
-
-						m_CurrentAddrVramB = MathRoundup(m_CurrentAddrVramB, addrAlign);
-						resultAddr		   = reinterpret_cast<void*>(m_CurrentAddrVramB);
-						m_CurrentAddrVramB += size;
+						m_VramAllocatorB.Print("VRAM-B");
+						NN_TPANIC_("Lack of resource on VRAM-B.\n");
 					}
 					break;
 				default:
@@ -162,102 +361,249 @@ namespace nn { namespace graphics {
 					break;
 			}
 
+			m_AllocationRegistry.Register(area, aim, id, resultAddr, size);
+
 #if DEBUG_PRINT
-			if (aim == NN_GX_MEM_SYSTEM)
+			NN_TLOG_("[graphics::MemoryManager] %s (id %d) is allocated at 0x%08X - 0x%08X on %s\n",
+					 GetMemoryAimName(GetMemoryAimIndex(aim)),
+					 id,
+					 resultAddr,
+					 reinterpret_cast<int>(resultAddr) + size - 1,
+					 GetMemoryAreaName(GetMemoryAreaIndex(area)));
+#endif	// #if DEBUG_PRINT
+
+			return resultAddr;
+		}
+
+		/* Memory deallocator for DMPGL */
+		void MemoryManager::Deallocate(GLenum area, GLenum aim, GLuint id, void* addr)
+		{
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			DeallocateImpl(area, aim, id, addr);
+		}
+
+		void MemoryManager::DeallocateImpl(GLenum area, GLenum aim, GLuint id, void* addr)
+		{
+			if (!m_Initialized)
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_SYSTEM is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				NN_TPANIC_("Not initialized.\n");
 			}
-			else if (aim == NN_GX_MEM_TEXTURE)
+
+#if DEBUG_PRINT
+			NN_TLOG_("[graphics::MemoryManager] (id %d) was deallocated at 0x%08X on %X\n", id, addr, area);
+#endif
+
+			if ((area != NN_GX_MEM_FCRAM) && (area != NN_GX_MEM_VRAMA) && (area != NN_GX_MEM_VRAMB))
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_TEXTURE is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				NN_TPANIC_("Invalid parameter.\n");
 			}
-			else if (aim == NN_GX_MEM_VERTEXBUFFER)
+
+			m_AllocationRegistry.Unregister(addr);
+
+			// The placement policy may have moved the buffer to another region than the one requested, so the address decides.
+			if (m_VramAllocatorA.IsInRegion(addr))
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_VERTEXBUFFER is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				if (!m_VramAllocatorA.Free(addr, aim, id))
+				{
+					NN_TPANIC_("Invalid address on VRAM-A.(0x%08X)\n", addr);
+				}
 			}
-			else if (aim == NN_GX_MEM_DISPLAYBUFFER)
+			else if (m_VramAllocatorB.IsInRegion(addr))
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_DISPLAYBUFFER is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				if (!m_VramAllocatorB.Free(addr, aim, id))
+				{
+					NN_TPANIC_("Invalid address on VRAM-B.(0x%08X)\n", addr);
+				}
 			}
-			else if (aim == NN_GX_MEM_RENDERBUFFER)
+			else
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_RENDERBUFFER is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				m_HeapOnFcram.Free(addr);
 			}
-			else if (aim == NN_GX_MEM_COMMANDBUFFER)
+		}
+
+		void* MemoryManager::Alloc(size_t size)
+		{
+			if (size == 0)
 			{
-				NN_TLOG_("[graphics::MemoryManager] NN_GX_MEM_COMMANDBUFFER is allocated at 0x%08X - 0x%08X on %X\n",
-						 resultAddr,
-						 reinterpret_cast<int>(resultAddr) + size - 1,
-						 area);
+				return NULL;
 			}
-#else
-			NN_UNUSED_VAR(id);
-#endif	// #if DEBUG_PRINT
 
-			return resultAddr;
+			u32 classIndex = SizeClassPool::GetClassIndex(size);
+			if (classIndex < SIZE_CLASS_POOL_CLASS_NUM)
+			{
+				ThreadCache* pThreadCache = (m_ThreadSafeFlag && (classIndex < THREAD_CACHE_CLASS_NUM)) ? FindThreadCache() : NULL;
+				if (pThreadCache != NULL)
+				{
+					void* ptr = pThreadCache->Pop(classIndex);
+					if (ptr != NULL)
+					{
+						pThreadCache->AddHitNum();
+						return ptr;
+					}
+
+					pThreadCache->AddMissNum();
+					RefillThreadCache(pThreadCache, classIndex);
+					ptr = pThreadCache->Pop(classIndex);
+					if (ptr != NULL)
+					{
+						return ptr;
+					}
+				}
+				else
+				{
+					ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+					void*				ptr = m_SizeClassPool.Allocate(classIndex);
+					if (ptr != NULL)
+					{
+						return ptr;
+					}
+				}
+
+				// The size class is full. The buffer comes from the heap and is freed there by address.
+				ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+				m_SizeClassPool.AddExhaustedNum(classIndex);
+			}
+
+			return Allocate(NN_GX_MEM_FCRAM, NN_GX_MEM_SYSTEM, 0, size);
 		}
 
-		/* Memory deallocator for DMPGL */
-		void MemoryManager::Deallocate(GLenum area, GLenum aim, GLuint id, void* addr)
+		void MemoryManager::Free(void* ptr)
 		{
-			NN_UNUSED_VAR(aim);
-			NN_UNUSED_VAR(id);
+			// The pool region does not change after initialization, so the address check needs no lock.
+			if (!m_SizeClassPool.IsInPool(ptr))
+			{
+				Deallocate(NN_GX_MEM_FCRAM, NN_GX_MEM_SYSTEM, 0, ptr);
+				return;
+			}
 
-			if (!m_Initialized)
+			u32			 classIndex	  = m_SizeClassPool.GetBlockClassIndex(ptr);
+			ThreadCache* pThreadCache = (m_ThreadSafeFlag && (classIndex < THREAD_CACHE_CLASS_NUM)) ? FindThreadCache() : NULL;
+			if (pThreadCache != NULL)
 			{
-				NN_TPANIC_("Not initialized.\n");
+				if (!pThreadCache->Push(classIndex, ptr))
+				{
+					FlushThreadCache(pThreadCache, classIndex, THREAD_CACHE_BLOCK_MAX_NUM / 2);
+					pThreadCache->Push(classIndex, ptr);
+				}
+				return;
 			}
 
-#if DEBUG_PRINT
-			NN_TLOG_("[graphics::MemoryManager] (id %d) was deallocated at 0x%08X on %X\n", id, addr, area);
-#endif
+			ScopedAllocatorLock lock(m_ThreadSafeFlag ? &m_CriticalSection : NULL);
+			m_SizeClassPool.Free(ptr);
+		}
 
-			switch (area)
+		bool MemoryManager::RegisterThread(void)
+		{
+			if (!m_ThreadSafeFlag)
 			{
-				case NN_GX_MEM_FCRAM:
-					m_HeapOnFcram.Free(addr);
-					break;
+				return false;
+			}
 
-				case NN_GX_MEM_VRAMA:
-				case NN_GX_MEM_VRAMB:
-					// Because the buffer in VRAM is simple, do not deallocate
+			if (FindThreadCache() != NULL)
+			{
+				return true;
+			}
+
+			ScopedAllocatorLock lock(&m_CriticalSection);
+			for (u32 cacheIndex = 0; cacheIndex < GRAPHICS_THREAD_CACHE_MAX_NUM; cacheIndex++)
+			{
+				if (!m_ThreadCacheArray[cacheIndex].IsBound())
+				{
+					m_ThreadCacheArray[cacheIndex].Bind(nn::os::Thread::GetCurrentId());
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void MemoryManager::UnregisterThread(void)
+		{
+			ThreadCache* pThreadCache = m_ThreadSafeFlag ? FindThreadCache() : NULL;
+			if (pThreadCache == NULL)
+			{
+				return;
+			}
+
+			for (u32 classIndex = 0; classIndex < THREAD_CACHE_CLASS_NUM; classIndex++)
+			{
+				FlushThreadCache(pThreadCache, classIndex, pThreadCache->GetBlockNum(classIndex));
+			}
+
+			ScopedAllocatorLock lock(&m_CriticalSection);
+			pThreadCache->Unbind();
+		}
+
+		void MemoryManager::RefillThreadCache(ThreadCache* pThreadCache, const u32 classIndex)
+		{
+			ScopedAllocatorLock lock(&m_CriticalSection);
+			for (u32 i = 0; i < THREAD_CACHE_REFILL_NUM; i++)
+			{
+				void* ptr = m_SizeClassPool.Allocate(classIndex);
+				if (ptr == NULL)
+				{
 					break;
+				}
+				pThreadCache->Push(classIndex, ptr);
+			}
+		}
 
-				default:
-					NN_TPANIC_("Invalid parameter.\n");
+		void MemoryManager::FlushThreadCache(ThreadCache* pThreadCache, const u32 classIndex, const u32 blockNum)
+		{
+			ScopedAllocatorLock lock(&m_CriticalSection);
+			for (u32 i = 0; i < blockNum; i++)
+			{
+				void* ptr = pThreadCache->Pop(classIndex);
+				if (ptr == NULL)
+				{
 					break;
+				}
+				m_SizeClassPool.Free(ptr);
 			}
 		}
+
+		ThreadCache* MemoryManager::FindThreadCache(void)
+		{
+			// A cache is bound and unbound only by its own thread, so the calling thread always sees its own cache consistently.
+			bit32 threadId = nn::os::Thread::GetCurrentId();
+			for (u32 cacheIndex = 0; cacheIndex < GRAPHICS_THREAD_CACHE_MAX_NUM; cacheIndex++)
+			{
+				if (m_ThreadCacheArray[cacheIndex].IsBound() && (m_ThreadCacheArray[cacheIndex].GetThreadId() == threadId))
+				{
+					return &m_ThreadCacheArray[cacheIndex];
+				}
+			}
+
+			return NULL;
+		}
 	}  // namespace detail
 
 	namespace {
 		graphics::detail::MemoryManager s_MemoryManager;
 	}
 
-	NN_WEAK_SYMBOL void InitializeMemoryManager(const uptr fcramAddress, const size_t memorySize)
+	NN_WEAK_SYMBOL void InitializeMemoryManager(const uptr fcramAddress, const size_t memorySize, const bool threadSafe)
 	{
-		s_MemoryManager.Initialize(fcramAddress, memorySize);
+		s_MemoryManager.Initialize(fcramAddress, memorySize, threadSafe);
 	}
 
 	NN_WEAK_SYMBOL void FinalizeMemoryManager(void) { s_MemoryManager.Finalize(); }
 
 	NN_WEAK_SYMBOL void PrintMemoryManagerInfo(void) { s_MemoryManager.PrintFreeMemorySize(); }
 
+	const detail::VramAllocator& GetVramAllocator(GLenum area) { return s_MemoryManager.GetVramAllocator(area); }
+
+	GLenum GetEmptierVramArea(void) { return s_MemoryManager.GetEmptierVramArea(); }
+
+	void SetMemoryPlacementPolicy(const MemoryPlacementPolicy policy) { s_MemoryManager.SetPlacementPolicy(policy); }
+
+	void GetMemorySnapshot(MemorySnapshot& snapshot) { s_MemoryManager.GetSnapshot(snapshot); }
+
+	void PrintMemoryLiveBlocks(const u32 maxNum, const MemoryBlockSortKey sortKey, const MemorySnapshot* pSince)
+	{
+		s_MemoryManager.PrintLiveBlocks(maxNum, sortKey, pSince);
+	}
+
 	NN_WEAK_SYMBOL void* GetAllocator(GLenum area, GLenum aim, GLuint id, GLsizei size)
 	{
 		return s_MemoryManager.Allocate(area, aim, id, size);
@@ -265,8 +611,12 @@ namespace nn { namespace graphics {
 
 	NN_WEAK_SYMBOL void GetDeallocator(GLenum area, GLenum aim, GLuint id, void* addr) { s_MemoryManager.Deallocate(area, aim, id, addr); }
 
-	NN_WEAK_SYMBOL void* Alloc(size_t size) { return s_MemoryManager.Allocate(NN_GX_MEM_FCRAM, NN_GX_MEM_SYSTEM, 0, size); }
+	NN_WEAK_SYMBOL void* Alloc(size_t size) { return s_MemoryManager.Alloc(size); }
+
+	NN_WEAK_SYMBOL void Free(void* ptr) { s_MemoryManager.Free(ptr); }
+
+	bool RegisterMemoryManagerThread(void) { return s_MemoryManager.RegisterThread(); }
 
-	NN_WEAK_SYMBOL void Free(void* ptr) { s_MemoryManager.Deallocate(NN_GX_MEM_FCRAM, NN_GX_MEM_SYSTEM, 0, ptr); }
+	void UnregisterMemoryManagerThread(void) { s_MemoryManager.UnregisterThread(); }
 
 }}	// namespace nn::graphics
@@ -1,7 +1,19 @@
+#include <cstring>
+
+#include "graphics/graphics_DrawStatistics.h"
+#include "graphics/graphics_GLStateCache.h"
 #include "graphics/graphics_ProgramObject.h"
 
 namespace nn { namespace graphics {
 
+	namespace {
+		// In 2D the vertex positions are already in normalized device coordinates.
+		const GLfloat s_IdentityMatrixArray[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+												   0.0f, 1.0f, 0.0f, 0.0f,
+												   0.0f, 0.0f, 1.0f, 0.0f,
+												   0.0f, 0.0f, 0.0f, 1.0f};
+	}  // namespace
+
 	/* ------------------------------------------------------------------------
 			<tt>ProgramObject</tt> Class Member Function
 	   ------------------------------------------------------------------------ */
@@ -10,19 +22,24 @@ namespace nn { namespace graphics {
 	: m_Initialized(false)
 	, m_VertexAttributes(VERTEX_NONE_ATTRIBUTE)
 	, m_Use3d(false)
+	, m_Matrix2dFlag(false)
 	, m_ProgramId(0)
+	, m_pUniformLocationTable(NULL)
+	, m_pCurrentUniformLocationTable(NULL)
+	, m_ProgramUniformLocationTable()
 	, m_ProjectionMatrix()
 	, m_ModelViewMatrix()
+	, m_StateCommandListId(0)
+	, m_StateCommandBufferOffset(0)
+	, m_StateCommandBufferSize(0)
+	, m_StateCommandRequestId(0)
 	{
 		for (u32 shaderIndex = 0; shaderIndex < PROGRAM_OBJECT_MAX_SHADERS; shaderIndex++)
 		{
 			m_ShaderIds[shaderIndex] = 0;
 		}
 
-		for (u32 locationIndex = 0; locationIndex < MAX_UNIFORM_LOCATIONS_NUM; locationIndex++)
-		{
-			m_UniformLocation[locationIndex] = -1;
-		}
+		ResetUniformCache();
 
 		MTX44Identity(&m_ProjectionMatrix);
 		MTX44Identity(&m_ModelViewMatrix);
@@ -36,6 +53,10 @@ namespace nn { namespace graphics {
 
 	u32 ProgramObject::GetVertexAttributes(void) { return m_VertexAttributes; }
 
+	GLuint ProgramObject::GetProgramId(void) const { return m_ProgramId; }
+
+	bool ProgramObject::IsInitialized(void) const { return m_Initialized; }
+
 	void ProgramObject::SetUse3d(const bool use3d) { m_Use3d = use3d; }
 
 	void ProgramObject::SetProjectionMatrix(const nn::math::MTX44& projectionMatrix) { m_ProjectionMatrix = projectionMatrix; }
@@ -46,6 +67,99 @@ namespace nn { namespace graphics {
 
 	void ProgramObject::Update(void) {}
 
+	void ProgramObject::SetupState(void) { UpdateModelViewProjectionMatrix(); }
+
+	void ProgramObject::SetUniformLocationTable(UniformLocationTable* pUniformLocationTable)
+	{
+		m_pUniformLocationTable = pUniformLocationTable;
+	}
+
+	bool ProgramObject::SaveStateCommand(void)
+	{
+		if (!m_Initialized || (m_StateCommandListId != 0))
+		{
+			return false;
+		}
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		GLuint currentCommandListId = 0;
+		nngxGetCmdlistParameteri(NN_GX_CMDLIST_BINDING, reinterpret_cast<GLint*>(&currentCommandListId));
+
+		nngxGenCmdlists(1, &m_StateCommandListId);
+		nngxBindCmdlist(m_StateCommandListId);
+		nngxCmdlistStorage(PROGRAM_STATE_COMMAND_LIST_SIZE, PROGRAM_STATE_COMMAND_REQUEST_NUM);
+		nngxStartCmdlistSave();
+
+		// The saved commands are for 2D rendering, and hold the whole state of the program, not only the part that differs from
+		// the previous program.
+		bool use3d = m_Use3d;
+		m_Use3d	   = false;
+		glUseProgram(m_ProgramId);
+		SetupState();
+		nngxUpdateState(PROGRAM_STATE_COMMAND_STATE_MASK);
+		nngxValidateState(PROGRAM_STATE_COMMAND_STATE_MASK, GL_FALSE);
+		m_Use3d = use3d;
+
+		GLsizei requestSize = 0;
+		nngxStopCmdlistSave(&m_StateCommandBufferOffset, &m_StateCommandBufferSize, &m_StateCommandRequestId, &requestSize);
+		nngxBindCmdlist(currentCommandListId);
+
+		// The state was validated into the saved command list, not into the current one. The first use of a basic shader saves
+		// its commands in the middle of a flush, so the current command list must get the whole state again.
+		nngxUpdateState(PROGRAM_STATE_COMMAND_STATE_MASK);
+
+		// The saved commands are added on their own, so they must not contain requests.
+		if (requestSize != 0)
+		{
+			NN_TPANIC_("The saved state commands contain requests. (requestSize = %d)\n", requestSize);
+		}
+
+		// The current program was changed behind the state cache.
+		GetGLStateCache().Invalidate();
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		return true;
+	}
+
+	void ProgramObject::FinalizeStateCommand(void)
+	{
+		if (m_StateCommandListId != 0)
+		{
+			nngxDeleteCmdlists(1, &m_StateCommandListId);
+			m_StateCommandListId = 0;
+		}
+
+		m_StateCommandBufferOffset = 0;
+		m_StateCommandBufferSize   = 0;
+		m_StateCommandRequestId	   = 0;
+	}
+
+	void ProgramObject::UseState(void)
+	{
+		// The driver must still know the current program to validate the vertex attributes of the draws.
+		if (GetGLStateCache().UseProgram(m_ProgramId))
+		{
+			GetCurrentDrawStatistics().m_ProgramBindNum += 1;
+		}
+
+		// The saved commands hold the matrices for 2D rendering, so they cannot be used in 3D.
+		if ((m_StateCommandListId == 0) || m_Use3d)
+		{
+			SetupState();
+			return;
+		}
+
+		// The commands are copied, so the saved command list can be added any number of times.
+		nngxUseSavedCmdlist(
+			m_StateCommandListId, m_StateCommandBufferOffset, m_StateCommandBufferSize, m_StateCommandRequestId, 0, 0, GL_TRUE);
+
+		// The saved commands changed the matrix registers behind the driver, so the next 3D use must set the matrices again.
+		m_UniformCachedArray[PROGRAM_UNIFORM_PROJECTION] = false;
+		m_UniformCachedArray[PROGRAM_UNIFORM_MODELVIEW]	= false;
+	}
+
 	void ProgramObject::InitializeVertexAttributes(void) { m_VertexAttributes = VERTEX_NONE_ATTRIBUTE; }
 
 	void ProgramObject::InitializeUniforms(void)
@@ -56,26 +170,23 @@ namespace nn { namespace graphics {
 			return;
 		}
 
-		// Vertex shader <tt>uniform</tt>.
-		m_UniformLocation[VERTEX_UNIFORM_PROJECTION] = glGetUniformLocation(m_ProgramId, "uProjection");
-		m_UniformLocation[VERTEX_UNIFORM_MODELVIEW]	 = glGetUniformLocation(m_ProgramId, "uModelView");
-
-		// <tt>uniform</tt> for the reserved fragment shader alpha test.
-		m_UniformLocation[FRAGMENT_UNIFORM_ALPHA_TEST] = glGetUniformLocation(m_ProgramId, "dmp_FragOperation.enableAlphaTest");
-		// <tt>uniform</tt> for the reserved fragment shader texture sampler.
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE0_SAMPLER_TYPE] = glGetUniformLocation(m_ProgramId, "dmp_Texture[0].samplerType");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE1_SAMPLER_TYPE] = glGetUniformLocation(m_ProgramId, "dmp_Texture[1].samplerType");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE2_SAMPLER_TYPE] = glGetUniformLocation(m_ProgramId, "dmp_Texture[2].samplerType");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXTURE3_SAMPLER_TYPE] = glGetUniformLocation(m_ProgramId, "dmp_Texture[3].samplerType");
-
-		// <tt>uniform</tt> for the reserved fragment shader texture combiner.
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_RGB]		  = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].srcRgb");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_SRC_ALPHA]	  = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].srcAlpha");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_RGB]	  = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].operandRgb");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_OPERAND_ALPHA] = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].operandAlpha");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_RGB]	  = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].combineRgb");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_COMBINE_ALPHA] = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].combineAlpha");
-		m_UniformLocation[FRAGMENT_UNIFORM_TEXENV2_CONST_RGBA]	  = glGetUniformLocation(m_ProgramId, "dmp_TexEnv[2].constRgba");
+		// The uniforms of a new program object have their initial values.
+		ResetUniformCache();
+
+		if (m_pUniformLocationTable == NULL)
+		{
+			NN_TPANIC_("The uniform location table is not set.\n");
+			return;
+		}
+
+		// The locations are only looked up for the first program of the shader binary, unless they differ for this one.
+		m_pCurrentUniformLocationTable = m_pUniformLocationTable;
+		if (!m_pUniformLocationTable->Initialize(m_ProgramId))
+		{
+			m_ProgramUniformLocationTable.Finalize();
+			m_ProgramUniformLocationTable.Initialize(m_ProgramId);
+			m_pCurrentUniformLocationTable = &m_ProgramUniformLocationTable;
+		}
 	}
 
 	void ProgramObject::UpdateModelViewProjectionMatrix(void)
@@ -88,39 +199,89 @@ namespace nn { namespace graphics {
 
 		if (m_Use3d)
 		{
-			glUniformMatrix4fv(m_UniformLocation[VERTEX_UNIFORM_PROJECTION], 1, GL_FALSE, static_cast<f32*>(m_ProjectionMatrix));
-			glUniformMatrix4fv(m_UniformLocation[VERTEX_UNIFORM_MODELVIEW], 1, GL_FALSE, static_cast<f32*>(m_ModelViewMatrix));
-		}
-		else
-		{
-			static bool	   initArrayFlag = false;
-			static GLfloat projectionArray[16];
-			static GLfloat modelViewArray[16];
-
-			if (!initArrayFlag)
-			{
-				for (u32 i = 0; i < 4; i++)
-				{
-					for (u32 j = 0; j < 4; j++)
-					{
-						if (i == j)
-						{
-							projectionArray[4 * i + j] = 1.0f;
-							modelViewArray[4 * i + j]  = 1.0f;
-						}
-						else
-						{
-							projectionArray[4 * i + j] = 0.0f;
-							modelViewArray[4 * i + j]  = 0.0f;
-						}
-					}
-				}
-
-				initArrayFlag = true;
-			}
-
-			glUniformMatrix4fv(m_UniformLocation[VERTEX_UNIFORM_PROJECTION], 1, GL_FALSE, projectionArray);
-			glUniformMatrix4fv(m_UniformLocation[VERTEX_UNIFORM_MODELVIEW], 1, GL_FALSE, modelViewArray);
+			SetUniformMatrix4fv(PROGRAM_UNIFORM_PROJECTION, static_cast<f32*>(m_ProjectionMatrix));
+			SetUniformMatrix4fv(PROGRAM_UNIFORM_MODELVIEW, static_cast<f32*>(m_ModelViewMatrix));
+
+			m_Matrix2dFlag = false;
+		}
+		else if (!m_Matrix2dFlag)
+		{
+			// The identity matrices are only set again after a 3D use changed them.
+			SetUniformMatrix4fv(PROGRAM_UNIFORM_PROJECTION, s_IdentityMatrixArray);
+			SetUniformMatrix4fv(PROGRAM_UNIFORM_MODELVIEW, s_IdentityMatrixArray);
+
+			m_Matrix2dFlag = true;
+		}
+	}
+
+	void ProgramObject::SetUniform1i(const u32 uniformIndex, const GLint value)
+	{
+		bit32 valueArray[1] = {static_cast<bit32>(value)};
+		if (UpdateUniformCache(uniformIndex, valueArray, 1))
+		{
+			glUniform1i(GetUniformLocation(uniformIndex), value);
+		}
+	}
+
+	void ProgramObject::SetUniform3i(const u32 uniformIndex, const GLint value0, const GLint value1, const GLint value2)
+	{
+		bit32 valueArray[3] = {static_cast<bit32>(value0), static_cast<bit32>(value1), static_cast<bit32>(value2)};
+		if (UpdateUniformCache(uniformIndex, valueArray, 3))
+		{
+			glUniform3i(GetUniformLocation(uniformIndex), value0, value1, value2);
+		}
+	}
+
+	void ProgramObject::SetUniform4fv(const u32 uniformIndex, const GLfloat* pValues)
+	{
+		bit32 valueArray[4];
+		std::memcpy(valueArray, pValues, sizeof(valueArray));
+		if (UpdateUniformCache(uniformIndex, valueArray, 4))
+		{
+			glUniform4fv(GetUniformLocation(uniformIndex), 1, pValues);
+		}
+	}
+
+	void ProgramObject::SetUniformMatrix4fv(const u32 uniformIndex, const GLfloat* pMatrix)
+	{
+		GLfloat* pCachedMatrix = m_UniformMatrixArray[uniformIndex];
+		if (m_UniformCachedArray[uniformIndex] && (std::memcmp(pCachedMatrix, pMatrix, sizeof(m_UniformMatrixArray[0])) == 0))
+		{
+			return;
+		}
+
+		std::memcpy(pCachedMatrix, pMatrix, sizeof(m_UniformMatrixArray[0]));
+		m_UniformCachedArray[uniformIndex] = true;
+
+		glUniformMatrix4fv(GetUniformLocation(uniformIndex), 1, GL_FALSE, pMatrix);
+	}
+
+	bool ProgramObject::UpdateUniformCache(const u32 uniformIndex, const bit32* pValues, const u32 valuesNum)
+	{
+		bit32* pCachedValues = m_UniformValueArray[uniformIndex];
+		if (m_UniformCachedArray[uniformIndex] && (std::memcmp(pCachedValues, pValues, valuesNum * sizeof(bit32)) == 0))
+		{
+			return false;
+		}
+
+		std::memcpy(pCachedValues, pValues, valuesNum * sizeof(bit32));
+		m_UniformCachedArray[uniformIndex] = true;
+
+		return true;
+	}
+
+	GLint ProgramObject::GetUniformLocation(const u32 uniformIndex) const
+	{
+		return m_pCurrentUniformLocationTable->GetLocation(uniformIndex);
+	}
+
+	void ProgramObject::ResetUniformCache(void)
+	{
+		m_Matrix2dFlag = false;
+
+		for (u32 uniformIndex = 0; uniformIndex < PROGRAM_UNIFORMS_NUM; uniformIndex++)
+		{
+			m_UniformCachedArray[uniformIndex] = false;
 		}
 	}
 
@@ -34,6 +34,23 @@ namespace nn { namespace graphics {
 		}
 	}
 
+	void GetWindowProjectionMatrix(const f32 windowWidth, const f32 windowHeight, nn::math::MTX44& projectionMatrix)
+	{
+		if ((windowWidth <= 0.0f) || (windowHeight <= 0.0f))
+		{
+			NN_TPANIC_("Invalid window size = (%f, %f)\n", windowWidth, windowHeight);
+		}
+
+		// The same conversion as RenderData::GetNormalizedDeviceCoordinateXY: the window y-axis becomes the x-axis of the LCD.
+		MTX44Identity(&projectionMatrix);
+		projectionMatrix.m[0][0] = 0.0f;
+		projectionMatrix.m[0][1] = -2.0f / windowWidth;
+		projectionMatrix.m[0][3] = 1.0f;
+		projectionMatrix.m[1][0] = -2.0f / windowHeight;
+		projectionMatrix.m[1][1] = 0.0f;
+		projectionMatrix.m[1][3] = 1.0f;
+	}
+
 	/* ------------------------------------------------------------------------
 			 <tt>RenderData</tt> Class Member Function
 	   ------------------------------------------------------------------------ */
@@ -44,6 +61,7 @@ namespace nn { namespace graphics {
 	, m_WindowHeight(NN_GX_DISPLAY0_HEIGHT)
 	, m_InverseWindowWidth(1.0f / NN_GX_DISPLAY0_WIDTH)
 	, m_InverseWindowHeight(1.0f / NN_GX_DISPLAY0_HEIGHT)
+	, m_ShaderWindowTransformFlag(false)
 	{
 		m_WindowWidth  = GetLcdWidth(m_RenderTarget);
 		m_WindowHeight = GetLcdHeight(m_RenderTarget);
@@ -65,11 +83,20 @@ namespace nn { namespace graphics {
 		CalculateInverseWindowSize();
 	}
 
+	void RenderData::SetShaderWindowTransform(const bool shaderFlag) { m_ShaderWindowTransformFlag = shaderFlag; }
+
 	void RenderData::GetNormalizedDeviceCoordinateXY(const f32 windowCoordinateX,
 													 const f32 windowCoordinateY,
 													 f32&	   normalizedDeviceCoordinateX,
 													 f32&	   normalizedDeviceCoordinateY)
 	{
+		if (m_ShaderWindowTransformFlag)
+		{
+			normalizedDeviceCoordinateX = windowCoordinateX;
+			normalizedDeviceCoordinateY = windowCoordinateY;
+			return;
+		}
+
 		normalizedDeviceCoordinateX = GetNormalizedDeviceCoordinateX(m_WindowWidth - windowCoordinateY);
 		normalizedDeviceCoordinateY = GetNormalizedDeviceCoordinateY(windowCoordinateX);
 	}
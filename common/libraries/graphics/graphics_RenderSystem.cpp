@@ -6,13 +6,20 @@ namespace nn { namespace graphics {
 	RenderSystem::RenderSystem(void)
 	: m_InitializeFlag(false)
 	, m_InitializeLcdDisplayFlag(false)
+	, m_ThreadSafeAllocatorFlag(false)
 	, m_TargetDisplay(NN_GX_DISPLAY0)
+	, m_CommandListNum(1)
+	, m_FrameArenaSize(GRAPHICS_FRAME_ARENA_DEFAULT_BUFFER_SIZE)
+	, m_PendingSwapDisplay(0)
+	, m_PendingSwapDisplayBufferId(0)
 	, m_CurrentDisplayBuffersPtr(NULL)
 	, m_CurrentFrameBufferPtr(NULL)
 	, m_DisplayBuffers0()
 	, m_FrameBuffer0()
 	, m_DisplayBuffers1()
 	{
+		m_Ordered2dModeFlagArray[0] = false;
+		m_Ordered2dModeFlagArray[1] = false;
 	}
 
 	RenderSystem::~RenderSystem(void) { Finalize(); }
@@ -36,18 +43,43 @@ namespace nn { namespace graphics {
 			NN_TPANIC_("Initialize() is called twice.\n");
 		}
 
-		graphics::InitializeMemoryManager(fcramAddress, memorySize);
+		graphics::InitializeMemoryManager(fcramAddress, memorySize, m_ThreadSafeAllocatorFlag);
 		if (nngxInitialize(graphics::GetAllocator, graphics::GetDeallocator) == GL_FALSE)
 		{
 			NN_TPANIC_("nngxInitialize() failed.\n");
 		}
 
-		m_CommandList.Initialize(commandBufferSize, requestNum, serialRunMode);
+		m_CommandList.Initialize(commandBufferSize, requestNum, serialRunMode, m_CommandListNum);
+		if (m_FrameArenaSize != 0)
+		{
+			graphics::InitializeFrameArena(m_FrameArenaSize, m_CommandListNum);
+		}
+
+		m_FrameProfiler.Initialize();
+		m_CommandList.SetFrameProfiler(&m_FrameProfiler);
 
-		DisplayBuffers::Create(displayBuffers0Desc, m_DisplayBuffers0);
+		// A frame is displayed only after the GPU has finished it, so a display buffer must not be reused by a transfer
+		// while one of the previous frames may still be on screen.
+		DisplayBuffersDescription displayBuffers0RingDesc = displayBuffers0Desc;
+		DisplayBuffersDescription displayBuffers1RingDesc = displayBuffers1Desc;
+		if (m_CommandListNum > 1)
+		{
+			if (displayBuffers0RingDesc.m_DisplayBufferNum <= m_CommandListNum)
+			{
+				displayBuffers0RingDesc.m_DisplayBufferNum = m_CommandListNum + 1;
+			}
+			if (displayBuffers1RingDesc.m_DisplayBufferNum <= m_CommandListNum)
+			{
+				displayBuffers1RingDesc.m_DisplayBufferNum = m_CommandListNum + 1;
+			}
+		}
+		m_PendingSwapDisplay		 = 0;
+		m_PendingSwapDisplayBufferId = 0;
+
+		DisplayBuffers::Create(displayBuffers0RingDesc, m_DisplayBuffers0);
 		GRAPHICS_ASSERT_GL_ERROR();
 
-		DisplayBuffers::Create(displayBuffers1Desc, m_DisplayBuffers1);
+		DisplayBuffers::Create(displayBuffers1RingDesc, m_DisplayBuffers1);
 		GRAPHICS_ASSERT_GL_ERROR();
 
 		FrameBuffer::Create(frameBuffer0Desc, m_FrameBuffer0);
@@ -99,6 +131,11 @@ namespace nn { namespace graphics {
 
 		GRAPHICS_ASSERT_GL_ERROR();
 
+		// The display buffers may still be written by a command list in flight.
+		m_CommandList.WaitRunning();
+		m_PendingSwapDisplay		 = 0;
+		m_PendingSwapDisplayBufferId = 0;
+
 		DisplayBuffers::Destroy(m_DisplayBuffers0);
 		DisplayBuffers::Destroy(m_DisplayBuffers1);
 		FrameBuffer::Destroy(m_FrameBuffer0);
@@ -109,6 +146,11 @@ namespace nn { namespace graphics {
 		m_CommandList.Finalize();
 		GRAPHICS_ASSERT_GL_ERROR();
 
+		m_CommandList.SetFrameProfiler(NULL);
+		m_FrameProfiler.Finalize();
+
+		graphics::FinalizeFrameArena();
+
 		nngxFinalize();
 		GRAPHICS_ASSERT_GL_ERROR();
 
@@ -159,7 +201,17 @@ namespace nn { namespace graphics {
 	{
 		CheckRenderTarget();
 
-		m_CurrentFrameBufferPtr->ClearBuffer(mask);
+		// A display in ordered 2D mode does not use its depth and stencil buffers.
+		GLbitfield clearMask = mask;
+		if (IsOrdered2dMode(m_TargetDisplay))
+		{
+			clearMask &= GL_COLOR_BUFFER_BIT;
+		}
+
+		if (clearMask != 0)
+		{
+			m_CurrentFrameBufferPtr->ClearBuffer(clearMask);
+		}
 	}
 
 	void RenderSystem::ClearColorDepthStencilBuffer(const GLclampf red,
@@ -292,9 +344,65 @@ namespace nn { namespace graphics {
 		m_CommandList.Run();
 		m_CommandList.Swap();
 
-		nngxSwapBuffers(m_TargetDisplay);
+		if (m_CommandListNum > 1)
+		{
+			// Run() has waited for the previous command list, so the previous frame can be displayed now.
+			// This frame is displayed by the next call.
+			SwapPendingDisplayBuffers();
+			m_PendingSwapDisplay		 = m_TargetDisplay;
+			m_PendingSwapDisplayBufferId = displayBufferId;
+		}
+		else
+		{
+			nngxSwapBuffers(m_TargetDisplay);
+		}
 
 		m_CurrentDisplayBuffersPtr->IncreaseBufferIndex();
+
+		// Swap() has waited for the command list that used the next buffer of the frame arena.
+		graphics::SwapFrameArena();
+		graphics::SwapDrawStatistics();
+	}
+
+	void RenderSystem::SwapPendingDisplayBuffers(void)
+	{
+		if (m_PendingSwapDisplay == 0)
+		{
+			return;
+		}
+
+		nngxActiveDisplay(m_PendingSwapDisplay);
+		nngxBindDisplaybuffer(m_PendingSwapDisplayBufferId);
+		nngxSwapBuffers(m_PendingSwapDisplay);
+
+		m_PendingSwapDisplay		 = 0;
+		m_PendingSwapDisplayBufferId = 0;
+	}
+
+	void RenderSystem::SkipSwapBuffers(void)
+	{
+		CheckRenderTarget();
+
+		// Nothing is transferred, but the command list still runs and the display is still swapped, as in any other frame.
+		// applet::CloseApplication() hangs when the frames stop doing so.
+		m_CommandList.Run();
+		m_CommandList.Swap();
+
+		// Run() has waited for the previous command list. If the last frame of the target display is still waiting, that swap
+		// displays it; otherwise the display is swapped to the buffer it already shows.
+		bool pendingTargetFlag = (m_PendingSwapDisplay == m_TargetDisplay);
+		SwapPendingDisplayBuffers();
+		if (!pendingTargetFlag)
+		{
+			nngxActiveDisplay(m_TargetDisplay);
+			nngxBindDisplaybuffer(m_CurrentDisplayBuffersPtr->GetPreviousTargetDisplayBufferId());
+			nngxSwapBuffers(m_TargetDisplay);
+		}
+
+		// The next frame draws into the same display buffer, so the buffer index is not increased. Swap() has waited for the
+		// command list that used the next buffer of the frame arena.
+		graphics::SwapFrameArena();
+		graphics::SwapDrawStatistics();
 	}
 
 	void RenderSystem::WaitVsync(const GLenum targetDisplay)
@@ -303,7 +411,12 @@ namespace nn { namespace graphics {
 
 		if ((targetDisplay == NN_GX_DISPLAY0) || (targetDisplay == NN_GX_DISPLAY1) || (targetDisplay == NN_GX_DISPLAY_BOTH))
 		{
+			m_FrameProfiler.Begin(FRAME_PROFILER_PHASE_VSYNC_WAIT);
 			nngxWaitVSync(targetDisplay);
+			m_FrameProfiler.End(FRAME_PROFILER_PHASE_VSYNC_WAIT);
+
+			// A frame ends with the wait for the VSync.
+			m_FrameProfiler.EndFrame();
 		}
 		else
 		{
@@ -313,6 +426,67 @@ namespace nn { namespace graphics {
 
 	void RenderSystem::SetSerialRun(const bool flag) { m_CommandList.SetSerialRun(flag); }
 
+	void RenderSystem::SetCommandListNum(const u32 commandListNum)
+	{
+		if (m_InitializeFlag)
+		{
+			NN_TPANIC_("SetCommandListNum() must be called before Initialize().\n");
+		}
+
+		if ((commandListNum == 0) || (commandListNum > GRAPHICS_COMMAND_LIST_NUM))
+		{
+			NN_TPANIC_("commandListNum(%d) must be 1 to %d.\n", commandListNum, GRAPHICS_COMMAND_LIST_NUM);
+		}
+
+		m_CommandListNum = commandListNum;
+	}
+
+	void RenderSystem::SetFrameArenaSize(const size_t bufferSize)
+	{
+		if (m_InitializeFlag)
+		{
+			NN_TPANIC_("SetFrameArenaSize() must be called before Initialize().\n");
+		}
+
+		m_FrameArenaSize = bufferSize;
+	}
+
+	void RenderSystem::SetThreadSafeAllocator(const bool flag)
+	{
+		if (m_InitializeFlag)
+		{
+			NN_TPANIC_("SetThreadSafeAllocator() must be called before Initialize().\n");
+		}
+
+		m_ThreadSafeAllocatorFlag = flag;
+	}
+
+	void RenderSystem::SetOrdered2dMode(const s32 display, const bool flag)
+	{
+		if (display == NN_GX_DISPLAY0 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_Ordered2dModeFlagArray[0] = flag;
+		}
+
+		if (display == NN_GX_DISPLAY1 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_Ordered2dModeFlagArray[1] = flag;
+		}
+	}
+
+	bool RenderSystem::IsOrdered2dMode(const GLenum display) const
+	{
+		// The extended display of the stereo mode is the right eye image of the upper LCD.
+		u32 displayIndex = (display == NN_GX_DISPLAY1) ? 1 : 0;
+		return m_Ordered2dModeFlagArray[displayIndex];
+	}
+
+	CommandList& RenderSystem::GetCommandList(void) { return m_CommandList; }
+
+	FrameProfiler& RenderSystem::GetFrameProfiler(void) { return m_FrameProfiler; }
+
+	const DrawStatistics& RenderSystem::GetDrawStatistics(void) const { return graphics::GetDrawStatistics(); }
+
 	void RenderSystem::CheckRenderTarget(void)
 	{
 		if (!m_InitializeFlag)
@@ -1,13 +1,33 @@
 #include "graphics/graphics_RenderSystemDrawing.h"
+#include "graphics/graphics_GLStateCache.h"
+
+#include <cstring>
 
 namespace nn { namespace graphics {
 
+	namespace {
+		// Kinds of the primitives recorded in the dirty regions, so that different primitives with the same data differ.
+		const u32 DIRTY_PRIMITIVE_CLEAR				= 0;
+		const u32 DIRTY_PRIMITIVE_POINT				= 1;
+		const u32 DIRTY_PRIMITIVE_LINE				= 2;
+		const u32 DIRTY_PRIMITIVE_SQUARE			= 3;
+		const u32 DIRTY_PRIMITIVE_RECTANGLE			= 4;
+		const u32 DIRTY_PRIMITIVE_TRIANGLE			= 5;
+		const u32 DIRTY_PRIMITIVE_TEXT				= 6;
+		const u32 DIRTY_PRIMITIVE_TEXTURED_TRIANGLE = 7;
+	}  // namespace
+
 	RenderSystemDrawing::RenderSystemDrawing(void)
 	: RenderSystem()
 	, m_InitializeTexturedTriangles(false)
-	, m_UseDecalTextureProgram(false)
+	, m_DirectVertexBufferFlag(false)
+	, m_ShaderWindowTransformFlag(false)
 	, m_MaxTexturedTrianglesNum(graphics::MAX_TEXTURED_TRIANGLES_NUM)
+	, m_FrameBufferDisplay(0)
 	{
+		m_DirtyRegionModeFlagArray[0] = false;
+		m_DirtyRegionModeFlagArray[1] = false;
+
 		for (u32 textureArrayIndex = 0; textureArrayIndex < graphics::MAX_TEXTURES_NUM; textureArrayIndex++)
 		{
 			m_TextureIdArray[textureArrayIndex]					= 0;
@@ -48,10 +68,13 @@ namespace nn { namespace graphics {
 								 isFillBlackLCD);
 
 		m_InitializeTexturedTriangles = false;
-		m_UseDecalTextureProgram	  = false;
 
 		// NOTE: <tt>nngxInitialize</tt> must be called in advance. It is called from within <tt>RenderSystem::Initialize</tt>.
 		m_GraphicsDrawing.Initialize();
+		// One vertex buffer per command list, so the next frame is packed while the previous one is drawn.
+		m_GraphicsDrawing.SetVertexBufferRingNum(m_CommandListNum);
+		m_GraphicsDrawing.SetDirectVertexBuffer(m_DirectVertexBufferFlag);
+		m_GraphicsDrawing.SetShaderWindowTransform(m_ShaderWindowTransformFlag);
 	}
 
 	void RenderSystemDrawing::InitializeTexturedTriangles(const u32 maxTrianglesNum)
@@ -70,15 +93,26 @@ namespace nn { namespace graphics {
 			m_TotalTexturedTrianglesNumArray[textureArrayIndex] = 0;
 
 			m_TexturedTrianglesRenderDataArray[textureArrayIndex].Initialize();
+			m_TexturedTrianglesRenderDataArray[textureArrayIndex].SetVertexBufferRingNum(m_CommandListNum);
+			m_TexturedTrianglesRenderDataArray[textureArrayIndex].SetDirectVertexBuffer(m_DirectVertexBufferFlag);
+			m_TexturedTrianglesRenderDataArray[textureArrayIndex].SetShaderWindowTransform(m_ShaderWindowTransformFlag);
 			m_TexturedTrianglesRenderDataArray[textureArrayIndex].InitializeVertexBuffers(vertexAttributes,
 																						  GL_TRIANGLES,
 																						  maxVerticesNum,
 																						  m_MaxTexturedTrianglesNum);
 		}
 
+		// The batch of each texture is its index in the array, below <tt>DRAW_SORT_BATCH_TRIANGLES</tt>, so textured triangles are drawn
+		// first in each layer.
 		for (u32 textureArrayIndex = 0; textureArrayIndex < graphics::MAX_TEXTURES_NUM; textureArrayIndex++)
 		{
 			m_TextureIdArray[textureArrayIndex] = 0;
+
+			m_GraphicsDrawing.m_DrawSortQueue.SetBatch(textureArrayIndex,
+													   &m_TexturedTrianglesRenderDataArray[textureArrayIndex],
+													   graphics::DECAL_TEXTURE_SHADER,
+													   false);
+			m_GraphicsDrawing.m_DrawSortQueue.SetBatchTexture(textureArrayIndex, 0);
 		}
 
 		m_InitializeTexturedTriangles = true;
@@ -92,6 +126,38 @@ namespace nn { namespace graphics {
 
 	void RenderSystemDrawing::InitializeTexts(const u32 maxLength) { m_GraphicsDrawing.InitializeTexts(maxLength); }
 
+	void RenderSystemDrawing::TrimRenderDataArrays(void)
+	{
+		for (u32 textureArrayIndex = 0; textureArrayIndex < MAX_TEXTURES_NUM; textureArrayIndex++)
+		{
+			m_TexturedTrianglesRenderDataArray[textureArrayIndex].TrimArrays();
+		}
+
+		m_GraphicsDrawing.TrimRenderDataArrays();
+	}
+
+	void RenderSystemDrawing::SetDirectVertexBuffer(const bool directFlag)
+	{
+		if (m_InitializeFlag)
+		{
+			NN_TPANIC_("SetDirectVertexBuffer() must be called before Initialize().\n");
+		}
+
+		m_DirectVertexBufferFlag = directFlag;
+	}
+
+	graphics::ShaderManager& RenderSystemDrawing::GetShaderManager(void) { return m_GraphicsDrawing.m_ShaderManager; }
+
+	void RenderSystemDrawing::SetShaderWindowTransform(const bool shaderFlag)
+	{
+		if (m_InitializeFlag)
+		{
+			NN_TPANIC_("SetShaderWindowTransform() must be called before Initialize().\n");
+		}
+
+		m_ShaderWindowTransformFlag = shaderFlag;
+	}
+
 	void RenderSystemDrawing::Finalize(void)
 	{
 		for (u32 textureArrayIndex = 0; textureArrayIndex < MAX_TEXTURES_NUM; textureArrayIndex++)
@@ -123,6 +189,7 @@ namespace nn { namespace graphics {
 		NN_UNUSED_VAR(y);
 
 		m_GraphicsDrawing.SetWindowSize(width, height);
+		GetDirtyRegion(m_TargetDisplay).SetWindowSize(width, height);
 
 		for (u32 textureArrayIndex = 0; textureArrayIndex < MAX_TEXTURES_NUM; textureArrayIndex++)
 		{
@@ -162,6 +229,40 @@ namespace nn { namespace graphics {
 		{
 			displayIndex = 1;
 		}
+
+		if (IsDirtyRegionMode(m_TargetDisplay))
+		{
+			// The color buffer is filled with a rectangle, which the scissor test of the dirty region applies to. The display is
+			// drawn in ordered 2D mode, so the depth and stencil buffers are not used.
+			CheckRenderTarget();
+			if (mask & GL_COLOR_BUFFER_BIT)
+			{
+				const f32* clearColor	 = m_ClearColorArray[displayIndex];
+				u32		   primitiveType = DIRTY_PRIMITIVE_CLEAR;
+				u32		   hash			 = DirtyRegion::Hash(graphics::DIRTY_REGION_HASH_SEED, &primitiveType, sizeof(primitiveType));
+				hash					 = DirtyRegion::Hash(hash, clearColor, 4 * sizeof(f32));
+				GetDirtyRegion(m_TargetDisplay).AddAll(hash);
+
+				f32 color[4] = {m_GraphicsDrawing.m_Color[0],
+								m_GraphicsDrawing.m_Color[1],
+								m_GraphicsDrawing.m_Color[2],
+								m_GraphicsDrawing.m_Color[3]};
+				u32 layer	 = m_GraphicsDrawing.GetLayer();
+
+				// The window x-axis is the long side of the LCD, which is the height of the viewport.
+				f32 windowWidth	 = 0.0f;
+				f32 windowHeight = 0.0f;
+				m_GraphicsDrawing.GetWindowSize(windowWidth, windowHeight);
+				m_GraphicsDrawing.SetLayer(0);
+				m_GraphicsDrawing.SetColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+				m_GraphicsDrawing.FillSquare(0.0f, 0.0f, 0.0f, windowWidth, windowHeight, windowWidth, windowHeight, 0.0f);
+
+				m_GraphicsDrawing.SetColor(color[0], color[1], color[2], color[3]);
+				m_GraphicsDrawing.SetLayer(layer);
+			}
+			return;
+		}
+
 		glClearColor(m_ClearColorArray[displayIndex][0],
 					 m_ClearColorArray[displayIndex][1],
 					 m_ClearColorArray[displayIndex][2],
@@ -170,6 +271,92 @@ namespace nn { namespace graphics {
 		RenderSystem::Clear(mask);
 	}
 
+	void RenderSystemDrawing::SetDirtyRegionMode(const s32 display, const bool flag)
+	{
+		if (display == NN_GX_DISPLAY0 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_DirtyRegionModeFlagArray[0] = flag;
+			m_DirtyRegionArray[0].Invalidate();
+		}
+
+		if (display == NN_GX_DISPLAY1 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_DirtyRegionModeFlagArray[1] = flag;
+			m_DirtyRegionArray[1].Invalidate();
+		}
+	}
+
+	bool RenderSystemDrawing::IsDirtyRegionMode(const GLenum display) const
+	{
+		u32 displayIndex = (display == NN_GX_DISPLAY1) ? 1 : 0;
+		return m_DirtyRegionModeFlagArray[displayIndex];
+	}
+
+	void RenderSystemDrawing::InvalidateDirtyRegion(const s32 display)
+	{
+		if (display == NN_GX_DISPLAY0 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_DirtyRegionArray[0].Invalidate();
+		}
+
+		if (display == NN_GX_DISPLAY1 || display == NN_GX_DISPLAY_BOTH)
+		{
+			m_DirtyRegionArray[1].Invalidate();
+		}
+	}
+
+	graphics::DirtyRegion& RenderSystemDrawing::GetDirtyRegion(const GLenum display)
+	{
+		// The extended display of the stereo mode is the right eye image of the upper LCD.
+		u32 displayIndex = (display == NN_GX_DISPLAY1) ? 1 : 0;
+		return m_DirtyRegionArray[displayIndex];
+	}
+
+	void RenderSystemDrawing::AddDirtyPrimitive(const u32	 primitiveType,
+												const f32*	 windowCoordinateArray,
+												const u32	 verticesNum,
+												const f32	 margin,
+												const void*	 pData,
+												const size_t dataSize)
+	{
+		if (!IsDirtyRegionMode(m_TargetDisplay))
+		{
+			return;
+		}
+
+		// The primitive looks the same as in the previous frame only if everything that decides its pixels is the same.
+		u32 layer = m_GraphicsDrawing.GetLayer();
+		u32 hash  = DirtyRegion::Hash(graphics::DIRTY_REGION_HASH_SEED, &primitiveType, sizeof(primitiveType));
+		hash	  = DirtyRegion::Hash(hash, m_GraphicsDrawing.m_Color, sizeof(m_GraphicsDrawing.m_Color));
+		hash	  = DirtyRegion::Hash(hash, &layer, sizeof(layer));
+		hash	  = DirtyRegion::Hash(hash, windowCoordinateArray, 2 * verticesNum * sizeof(f32));
+		if (pData != NULL)
+		{
+			hash = DirtyRegion::Hash(hash, pData, dataSize);
+		}
+
+		f32 minWindowCoordinateX = windowCoordinateArray[0];
+		f32 minWindowCoordinateY = windowCoordinateArray[1];
+		f32 maxWindowCoordinateX = windowCoordinateArray[0];
+		f32 maxWindowCoordinateY = windowCoordinateArray[1];
+		for (u32 vertexIndex = 1; vertexIndex < verticesNum; vertexIndex++)
+		{
+			f32 windowCoordinateX = windowCoordinateArray[2 * vertexIndex];
+			f32 windowCoordinateY = windowCoordinateArray[2 * vertexIndex + 1];
+
+			minWindowCoordinateX = (windowCoordinateX < minWindowCoordinateX) ? windowCoordinateX : minWindowCoordinateX;
+			minWindowCoordinateY = (windowCoordinateY < minWindowCoordinateY) ? windowCoordinateY : minWindowCoordinateY;
+			maxWindowCoordinateX = (windowCoordinateX > maxWindowCoordinateX) ? windowCoordinateX : maxWindowCoordinateX;
+			maxWindowCoordinateY = (windowCoordinateY > maxWindowCoordinateY) ? windowCoordinateY : maxWindowCoordinateY;
+		}
+
+		GetDirtyRegion(m_TargetDisplay).Add(minWindowCoordinateX - margin,
+											minWindowCoordinateY - margin,
+											maxWindowCoordinateX + margin,
+											maxWindowCoordinateY + margin,
+											hash);
+	}
+
 	void RenderSystemDrawing::SetColor(const f32 red, const f32 green, const f32 blue, const f32 alpha)
 	{
 		m_GraphicsDrawing.SetColor(red, green, blue, alpha);
@@ -181,10 +368,16 @@ namespace nn { namespace graphics {
 
 	void RenderSystemDrawing::SetAutoDepth(const bool enableAutoDepth) { m_GraphicsDrawing.SetAutoDepth(enableAutoDepth); }
 
+	void RenderSystemDrawing::SetLayer(const u32 layer) { m_GraphicsDrawing.SetLayer(layer); }
+
 	void RenderSystemDrawing::SetPointSize(const f32 pointSize) { m_GraphicsDrawing.SetPointSize(pointSize); }
 
 	void RenderSystemDrawing::DrawPoint(const f32 windowCoordinateX, const f32 windowCoordinateY)
 	{
+		f32 windowCoordinateArray[2] = {windowCoordinateX, windowCoordinateY};
+		f32 pointSize				 = m_GraphicsDrawing.GetPointSize();
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_POINT, windowCoordinateArray, 1, 0.5f * pointSize, &pointSize, sizeof(pointSize));
+
 		m_GraphicsDrawing.DrawPoint(windowCoordinateX, windowCoordinateY);
 	}
 
@@ -196,6 +389,11 @@ namespace nn { namespace graphics {
 									   const f32 windowCoordinateY1)
 	{
 		CheckRenderTarget();
+
+		f32 windowCoordinateArray[4] = {windowCoordinateX0, windowCoordinateY0, windowCoordinateX1, windowCoordinateY1};
+		f32 lineWidth				 = m_GraphicsDrawing.GetLineWidth();
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_LINE, windowCoordinateArray, 2, 0.5f * lineWidth, &lineWidth, sizeof(lineWidth));
+
 		m_GraphicsDrawing.DrawLine(windowCoordinateX0, windowCoordinateY0, windowCoordinateX1, windowCoordinateY1);
 	}
 
@@ -209,6 +407,17 @@ namespace nn { namespace graphics {
 										 const f32 windowCoordinateY3)
 	{
 		CheckRenderTarget();
+
+		f32 windowCoordinateArray[8] = {windowCoordinateX0,
+										windowCoordinateY0,
+										windowCoordinateX1,
+										windowCoordinateY1,
+										windowCoordinateX2,
+										windowCoordinateY2,
+										windowCoordinateX3,
+										windowCoordinateY3};
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_SQUARE, windowCoordinateArray, 4, 0.0f, NULL, 0);
+
 		m_GraphicsDrawing.FillSquare(windowCoordinateX0,
 									 windowCoordinateY0,
 									 windowCoordinateX1,
@@ -222,6 +431,10 @@ namespace nn { namespace graphics {
 	void RenderSystemDrawing::FillRectangle(const f32 windowCoordinateX, const f32 windowCoordinateY, const f32 width, const f32 height)
 	{
 		CheckRenderTarget();
+
+		f32 windowCoordinateArray[4] = {windowCoordinateX, windowCoordinateY, windowCoordinateX + width, windowCoordinateY + height};
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_RECTANGLE, windowCoordinateArray, 2, 0.0f, NULL, 0);
+
 		m_GraphicsDrawing.FillRectangle(windowCoordinateX, windowCoordinateY, width, height);
 	}
 
@@ -233,6 +446,15 @@ namespace nn { namespace graphics {
 										   const f32 windowCoordinateY2)
 	{
 		CheckRenderTarget();
+
+		f32 windowCoordinateArray[6] = {windowCoordinateX0,
+										windowCoordinateY0,
+										windowCoordinateX1,
+										windowCoordinateY1,
+										windowCoordinateX2,
+										windowCoordinateY2};
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_TRIANGLE, windowCoordinateArray, 3, 0.0f, NULL, 0);
+
 		m_GraphicsDrawing.FillTriangle(windowCoordinateX0,
 									   windowCoordinateY0,
 									   windowCoordinateX1,
@@ -255,9 +477,48 @@ namespace nn { namespace graphics {
 		vsnprintf(textBuffer, tmpBufferSize, format, va);
 		va_end(va);
 
+		if (IsDirtyRegionMode(m_TargetDisplay))
+		{
+			// The text is as high as the font size and each character as wide. The characters past those drawn only widen the box.
+			u32 textLength = std::strlen(textBuffer);
+			if (textLength > graphics::MAX_CHAR_LENGTH_PER_LINE)
+			{
+				textLength = graphics::MAX_CHAR_LENGTH_PER_LINE;
+			}
+
+			f32 fontSize				 = m_GraphicsDrawing.GetFontSize();
+			f32 windowCoordinateArray[4] = {windowCoordinateX,
+											windowCoordinateY,
+											windowCoordinateX + fontSize * textLength,
+											windowCoordinateY + fontSize};
+			u32 hash					 = DirtyRegion::Hash(graphics::DIRTY_REGION_HASH_SEED, textBuffer, textLength);
+			hash						 = DirtyRegion::Hash(hash, &fontSize, sizeof(fontSize));
+			AddDirtyPrimitive(DIRTY_PRIMITIVE_TEXT, windowCoordinateArray, 2, 0.0f, &hash, sizeof(hash));
+		}
+
 		m_GraphicsDrawing.DrawTextBuffer(windowCoordinateX, windowCoordinateY, textBuffer);
 	}
 
+	void RenderSystemDrawing::DrawFrameProfiler(const f32 windowCoordinateX, const f32 windowCoordinateY)
+	{
+		CheckRenderTarget();
+
+		f32 lineHeight = m_GraphicsDrawing.GetFontSize();
+
+		DrawText(windowCoordinateX, windowCoordinateY, "%-10s %6s %6s %6s", "usec", "avg", "max", "p99");
+		for (u32 phase = 0; phase < FRAME_PROFILER_PHASE_NUM; phase++)
+		{
+			FrameProfilerPhase profilerPhase = static_cast<FrameProfilerPhase>(phase);
+			DrawText(windowCoordinateX,
+					 windowCoordinateY + lineHeight * (phase + 1),
+					 "%-10s %6lld %6lld %6lld",
+					 FrameProfiler::GetPhaseName(profilerPhase),
+					 m_FrameProfiler.GetAverageMicroSeconds(profilerPhase),
+					 m_FrameProfiler.GetMaxMicroSeconds(profilerPhase),
+					 m_FrameProfiler.GetPercentileMicroSeconds(profilerPhase, 99));
+		}
+	}
+
 	bool RenderSystemDrawing::HasTexture(const GLuint textureId)
 	{
 		if (!m_InitializeFlag)
@@ -312,6 +573,9 @@ namespace nn { namespace graphics {
 		GRAPHICS_ASSERT_GL_ERROR();
 
 		m_TextureIdArray[textureArrayIndex] = textureId;
+		m_GraphicsDrawing.m_DrawSortQueue.SetBatchTexture(textureArrayIndex, textureId);
+		// A texture object name may be reused for another image.
+		InvalidateDirtyRegion(NN_GX_DISPLAY_BOTH);
 
 		return true;
 	}
@@ -340,6 +604,7 @@ namespace nn { namespace graphics {
 			GRAPHICS_ASSERT_GL_ERROR();
 
 			m_TextureIdArray[textureArrayIndex] = 0;
+			m_GraphicsDrawing.m_DrawSortQueue.SetBatchTexture(textureArrayIndex, 0);
 
 			return true;
 		}
@@ -452,20 +717,36 @@ namespace nn { namespace graphics {
 			return;
 		}
 
+		f32 windowCoordinateArray[6] = {windowCoordinateX0,
+										windowCoordinateY0,
+										windowCoordinateX1,
+										windowCoordinateY1,
+										windowCoordinateX2,
+										windowCoordinateY2};
+		f32 texcoordArray[6]		 = {texcoordS0, texcoordT0, texcoordS1, texcoordT1, texcoordS2, texcoordT2};
+		u32 hash					 = DirtyRegion::Hash(graphics::DIRTY_REGION_HASH_SEED, texcoordArray, sizeof(texcoordArray));
+		hash						 = DirtyRegion::Hash(hash, &textureId, sizeof(textureId));
+		AddDirtyPrimitive(DIRTY_PRIMITIVE_TEXTURED_TRIANGLE, windowCoordinateArray, 3, 0.0f, &hash, sizeof(hash));
+
 		if (m_TotalTexturedTrianglesNumArray[textureArrayIndex] >= m_MaxTexturedTrianglesNum)
 		{
 			NN_TLOG_("RenderSystemDrawing::FillTexturedTriangle() maxTriangles limit\n");
 			NN_TLOG_("  trianglesIndex = %d, maxTrianglesNum = %d\n",
 					 m_TotalTexturedTrianglesNumArray[textureArrayIndex],
 					 m_MaxTexturedTrianglesNum);
+			GetCurrentDrawStatistics().m_DroppedTexturedTrianglesNum += 1;
 			return;
 		}
 
-		m_UseDecalTextureProgram = true;
-
 		graphics::TrianglesRenderData& renderData	 = m_TexturedTrianglesRenderDataArray[textureArrayIndex];
 		u32							   triangleIndex = renderData.GetPackedTrianglesNum();
 
+		if (!m_GraphicsDrawing.AddSortedPrimitive(textureArrayIndex, 3 * triangleIndex, 3))
+		{
+			GetCurrentDrawStatistics().m_DroppedTexturedTrianglesNum += 1;
+			return;
+		}
+
 		f32 s_Depth = m_GraphicsDrawing.m_Depth;
 
 		// POSITION0
@@ -505,58 +786,79 @@ namespace nn { namespace graphics {
 		renderData.AddPackedTrianglesNum(1);
 
 		m_TotalTexturedTrianglesNumArray[textureArrayIndex] += 1;
+		GetCurrentDrawStatistics().m_TexturedTrianglesNum += 1;
 	}
 
 	void RenderSystemDrawing::SwapBuffers(void)
 	{
 		CheckRenderTarget();
 
-		RenderSystemDrawing::Flush();
-		RenderSystem::SwapBuffers();
-	}
-
-	void RenderSystemDrawing::Flush(void)
-	{
-		FlushTexturedPrimitives();
-		m_GraphicsDrawing.Flush();
-	}
-
-	void RenderSystemDrawing::FlushTexturedPrimitives(void)
-	{
-		if (!m_UseDecalTextureProgram)
+		if (!IsDirtyRegionMode(m_TargetDisplay))
 		{
+			RenderSystemDrawing::Flush();
+			RenderSystem::SwapBuffers();
+			m_FrameBufferDisplay = m_TargetDisplay;
 			return;
 		}
 
-		graphics::ProgramObject* shaderProgramPtr = m_GraphicsDrawing.m_ShaderManager.GetShaderProgram(graphics::DECAL_TEXTURE_SHADER);
-		shaderProgramPtr->SetUse3d(false);
-		shaderProgramPtr->Begin();
-		shaderProgramPtr->Use();
+		// Only the frame buffer that still holds the last frame of the display can be redrawn in part.
+		graphics::DirtyRegion& dirtyRegion = GetDirtyRegion(m_TargetDisplay);
+		if (m_FrameBufferDisplay != m_TargetDisplay)
+		{
+			dirtyRegion.Invalidate();
+		}
 
-		for (u32 textureArrayIndex = 0; textureArrayIndex < graphics::MAX_TEXTURES_NUM; textureArrayIndex++)
+		GLint	scissorX	  = 0;
+		GLint	scissorY	  = 0;
+		GLsizei scissorWidth  = 0;
+		GLsizei scissorHeight = 0;
+		if (!dirtyRegion.EndFrame(scissorX, scissorY, scissorWidth, scissorHeight))
 		{
-			if (m_TextureIdArray[textureArrayIndex] != 0)
+			m_GraphicsDrawing.DiscardPrimitives();
+			for (u32 textureArrayIndex = 0; textureArrayIndex < graphics::MAX_TEXTURES_NUM; textureArrayIndex++)
 			{
-				graphics::TrianglesRenderData& renderData		  = m_TexturedTrianglesRenderDataArray[textureArrayIndex];
-				u32							   packedTrianglesNum = renderData.GetPackedTrianglesNum();
-				if (packedTrianglesNum != 0)
-				{
-					GLuint textureId = m_TextureIdArray[textureArrayIndex];
-					if (textureId != 0)
-					{
-						shaderProgramPtr->SetTextureId(textureId);
-						shaderProgramPtr->Update();
-						renderData.DrawPackedTriangles();
-					}
-				}
-
 				m_TotalTexturedTrianglesNumArray[textureArrayIndex] = 0;
 			}
+
+			RenderSystem::SkipSwapBuffers();
+			return;
+		}
+
+		// The rest of the color buffer holds the last frame, so all of it is transferred. The scissor state of the application is
+		// restored afterwards.
+		GLboolean scissorTestFlag = glIsEnabled(GL_SCISSOR_TEST);
+		GLint	  scissorBox[4];
+		glGetIntegerv(GL_SCISSOR_BOX, scissorBox);
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(scissorX, scissorY, scissorWidth, scissorHeight);
+
+		RenderSystemDrawing::Flush();
+
+		glScissor(scissorBox[0], scissorBox[1], scissorBox[2], scissorBox[3]);
+		if (!scissorTestFlag)
+		{
+			glDisable(GL_SCISSOR_TEST);
 		}
 
-		shaderProgramPtr->End();
+		RenderSystem::SwapBuffers();
+		m_FrameBufferDisplay = m_TargetDisplay;
+	}
 
-		m_UseDecalTextureProgram = false;
+	void RenderSystemDrawing::Flush(void)
+	{
+		// The vertex data are uploaded to, or in direct vertex buffer mode written into, the next entry of each ring, which no command
+		// list in flight reads, so there is no need to wait for the GPU here.
+		m_FrameProfiler.Begin(FRAME_PROFILER_PHASE_FLUSH);
+		// The application may have changed the GL state since the last flush.
+		GetGLStateCache().Invalidate();
+		// Textured triangles are drawn with the other primitives, in the order of their layer, shader program and texture.
+		m_GraphicsDrawing.SetOrdered2dMode(IsOrdered2dMode(m_TargetDisplay) || IsDirtyRegionMode(m_TargetDisplay));
+		m_GraphicsDrawing.Flush();
+		for (u32 textureArrayIndex = 0; textureArrayIndex < graphics::MAX_TEXTURES_NUM; textureArrayIndex++)
+		{
+			m_TotalTexturedTrianglesNumArray[textureArrayIndex] = 0;
+		}
+		m_FrameProfiler.End(FRAME_PROFILER_PHASE_FLUSH);
 	}
 
 }}	// namespace nn::graphics
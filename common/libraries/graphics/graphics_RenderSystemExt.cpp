@@ -318,6 +318,9 @@ namespace nn { namespace graphics {
 			return;
 		}
 
+		// The transferred images must be complete before they are displayed.
+		m_CommandList.WaitRunning();
+
 		if ((m_TargetDisplay == NN_GX_DISPLAY0) && (m_ChangeLcdMode) && (m_LcdMode == NN_GX_DISPLAYMODE_STEREO))
 		{
 			// If and only if you have switched to STEREO mode, temporarily bind the left-eye display buffer to the right-eye display.
@@ -336,6 +339,9 @@ namespace nn { namespace graphics {
 			nngxSwapBuffers(NN_GX_DISPLAY1);
 		}
 
+		graphics::SwapFrameArena();
+		graphics::SwapDrawStatistics();
+
 		GRAPHICS_ASSERT_GL_ERROR();
 	}
 
@@ -348,7 +354,11 @@ namespace nn { namespace graphics {
 
 		if ((targetDisplay == NN_GX_DISPLAY0) || (targetDisplay == NN_GX_DISPLAY1) || (targetDisplay == NN_GX_DISPLAY_BOTH))
 		{
+			m_FrameProfiler.Begin(FRAME_PROFILER_PHASE_VSYNC_WAIT);
 			nngxWaitVSync(targetDisplay);
+			m_FrameProfiler.End(FRAME_PROFILER_PHASE_VSYNC_WAIT);
+
+			m_FrameProfiler.EndFrame();
 		}
 		else
 		{
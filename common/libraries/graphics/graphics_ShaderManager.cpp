@@ -1,3 +1,4 @@
+#include "graphics/graphics_GLStateCache.h"
 #include "graphics/graphics_ShaderManager.h"
 
 extern "C"
@@ -12,7 +13,13 @@ namespace nn { namespace graphics {
 		<tt>ShaderManager</tt> Class Member Function
 		------------------------------------------------------------------------ */
 
-	ShaderManager::ShaderManager(void) : m_Initialized(false), m_ColorFillProgram(), m_FontProgram(), m_DecalTextureProgram() {}
+	ShaderManager::ShaderManager(void)
+	: m_Initialized(false)
+	, m_ColorFillProgram()
+	, m_FontProgram()
+	, m_DecalTextureProgram()
+	{
+	}
 
 	ShaderManager::~ShaderManager(void) {}
 
@@ -25,11 +32,19 @@ namespace nn { namespace graphics {
 
 		for (u32 shaderBinaryIndex = 0; shaderBinaryIndex < MAX_SHADER_BINARY_NUM; shaderBinaryIndex++)
 		{
-			for (u32 shaderProgramIndex = 0; shaderProgramIndex < MAX_SHADER_PROGRAM_NUM; shaderProgramIndex++)
+			for (u32 shaderIndex = 0; shaderIndex < MAX_SHADER_PROGRAM_NUM; shaderIndex++)
 			{
-				m_ShaderProgramIdArray[shaderBinaryIndex][shaderProgramIndex]  = 0;
-				m_ShaderProgramPtrArray[shaderBinaryIndex][shaderProgramIndex] = NULL;
+				m_ShaderIdArray[shaderBinaryIndex][shaderIndex] = 0;
 			}
+
+			m_ShaderNumArray[shaderBinaryIndex] = 0;
+		}
+
+		for (u32 programId = 0; programId < MAX_SHADER_PROGRAM_REGISTRY_NUM; programId++)
+		{
+			m_ShaderProgramPtrArray[programId]	= NULL;
+			m_ShaderBinaryIndexArray[programId] = 0;
+			m_ShaderIndexArray[programId]		= 0;
 		}
 
 		m_Initialized = true;
@@ -45,36 +60,176 @@ namespace nn { namespace graphics {
 
 	bool ShaderManager::InitializeBasicShader(void)
 	{
-		for (u32 shaderProgramIndex = 0; shaderProgramIndex < BASIC_SHADER_BINARY_SHADER_NUM; shaderProgramIndex++)
+		// The basic shader binary is the first one loaded, so it gets BASIC_SHADER_BINARY_INDEX.
+		u32 shaderBinaryIndex = 0;
+		if (!LoadShaderBinary(BasicVShader_SHADER_BEGIN,
+							  reinterpret_cast<s32>(BasicVShader_SHADER_END) - reinterpret_cast<s32>(BasicVShader_SHADER_BEGIN),
+							  BASIC_SHADER_BINARY_SHADER_NUM,
+							  shaderBinaryIndex))
 		{
-			m_ShaderProgramIdArray[BASIC_SHADER_BINARY_INDEX][shaderProgramIndex] = glCreateShader(GL_VERTEX_SHADER);
+			return false;
 		}
 
-		glShaderBinary(BASIC_SHADER_BINARY_SHADER_NUM,
-					   &m_ShaderProgramIdArray[BASIC_SHADER_BINARY_INDEX][0],
-					   GL_PLATFORM_BINARY_DMP,
-					   BasicVShader_SHADER_BEGIN,
-					   reinterpret_cast<s32>(BasicVShader_SHADER_END) - reinterpret_cast<s32>(BasicVShader_SHADER_BEGIN));
+		// The basic shaders bind their uniforms to the same registers, so their locations are looked up only once.
+		m_UniformLocationTableArray[shaderBinaryIndex].SetCheckFlag(false);
 
-		u32 shaderBinaryIndex = BASIC_SHADER_BINARY_INDEX;
+		bool flag = RegisterShaderProgram(COLOR_FILL_SHADER, &m_ColorFillProgram, shaderBinaryIndex, COLOR_FILL_SHADER);
+		flag	  = flag && RegisterShaderProgram(FONT_SHADER, &m_FontProgram, shaderBinaryIndex, FONT_SHADER);
+		flag	  = flag && RegisterShaderProgram(DECAL_TEXTURE_SHADER, &m_DecalTextureProgram, shaderBinaryIndex, DECAL_TEXTURE_SHADER);
 
-		// ColorFillShader
-		u32	   shaderType = COLOR_FILL_SHADER;
-		GLuint shaderId	  = m_ShaderProgramIdArray[BASIC_SHADER_BINARY_INDEX][shaderType];
-		m_ColorFillProgram.Initialize(shaderId);
-		m_ShaderProgramPtrArray[shaderBinaryIndex][shaderType] = &m_ColorFillProgram;
+		return flag;
+	}
 
-		// FontShader
-		shaderType = FONT_SHADER;
-		shaderId   = m_ShaderProgramIdArray[BASIC_SHADER_BINARY_INDEX][shaderType];
-		m_FontProgram.Initialize(shaderId);
-		m_ShaderProgramPtrArray[shaderBinaryIndex][shaderType] = &m_FontProgram;
+	bool ShaderManager::LoadShaderBinary(const void* pShaderBinary, const s32 shaderBinarySize, const u32 shaderNum, u32& shaderBinaryIndex)
+	{
+		if (!m_Initialized)
+		{
+			return false;
+		}
+
+		GRAPHICS_ASSERT_GL_ERROR();
 
-		// DecalTextureShader
-		shaderType = DECAL_TEXTURE_SHADER;
-		shaderId   = m_ShaderProgramIdArray[BASIC_SHADER_BINARY_INDEX][shaderType];
-		m_DecalTextureProgram.Initialize(shaderId);
-		m_ShaderProgramPtrArray[shaderBinaryIndex][shaderType] = &m_DecalTextureProgram;
+		if ((shaderNum == 0) || (shaderNum > MAX_SHADER_PROGRAM_NUM))
+		{
+			NN_TLOG_("ShaderManager::LoadShaderBinary() : Invalid shaderNum = %d (Max = %d)\n", shaderNum, MAX_SHADER_PROGRAM_NUM);
+			return false;
+		}
+
+		for (shaderBinaryIndex = 0; shaderBinaryIndex < MAX_SHADER_BINARY_NUM; shaderBinaryIndex++)
+		{
+			if (m_ShaderNumArray[shaderBinaryIndex] == 0)
+			{
+				break;
+			}
+		}
+
+		if (shaderBinaryIndex == MAX_SHADER_BINARY_NUM)
+		{
+			NN_TLOG_("ShaderManager::LoadShaderBinary() : No room for a shader binary (Max = %d)\n", MAX_SHADER_BINARY_NUM);
+			return false;
+		}
+
+		GLuint* shaderIdArray = m_ShaderIdArray[shaderBinaryIndex];
+		for (u32 shaderIndex = 0; shaderIndex < shaderNum; shaderIndex++)
+		{
+			shaderIdArray[shaderIndex] = glCreateShader(GL_VERTEX_SHADER);
+		}
+
+		glShaderBinary(shaderNum, shaderIdArray, GL_PLATFORM_BINARY_DMP, pShaderBinary, shaderBinarySize);
+
+		// A broken binary of a title is reported to the caller instead of stopping the library.
+		GLenum errorCode = glGetError();
+		if (errorCode != GL_NO_ERROR)
+		{
+			PrintGLError(errorCode);
+
+			for (u32 shaderIndex = 0; shaderIndex < shaderNum; shaderIndex++)
+			{
+				glDeleteShader(shaderIdArray[shaderIndex]);
+				shaderIdArray[shaderIndex] = 0;
+			}
+
+			return false;
+		}
+
+		m_ShaderNumArray[shaderBinaryIndex] = shaderNum;
+
+		return true;
+	}
+
+	bool ShaderManager::UnloadShaderBinary(const u32 shaderBinaryIndex)
+	{
+		if ((shaderBinaryIndex >= MAX_SHADER_BINARY_NUM) || (m_ShaderNumArray[shaderBinaryIndex] == 0))
+		{
+			return false;
+		}
+
+		for (u32 programId = 0; programId < MAX_SHADER_PROGRAM_REGISTRY_NUM; programId++)
+		{
+			if ((m_ShaderProgramPtrArray[programId] != NULL) && (m_ShaderBinaryIndexArray[programId] == shaderBinaryIndex))
+			{
+				NN_TLOG_("ShaderManager::UnloadShaderBinary() : Shader program %d still uses the shader binary.\n", programId);
+				return false;
+			}
+		}
+
+		for (u32 shaderIndex = 0; shaderIndex < m_ShaderNumArray[shaderBinaryIndex]; shaderIndex++)
+		{
+			glDeleteShader(m_ShaderIdArray[shaderBinaryIndex][shaderIndex]);
+			m_ShaderIdArray[shaderBinaryIndex][shaderIndex] = 0;
+		}
+
+		m_ShaderNumArray[shaderBinaryIndex] = 0;
+		m_UniformLocationTableArray[shaderBinaryIndex].Finalize();
+
+		return true;
+	}
+
+	bool ShaderManager::RegisterShaderProgram(const u32		 programId,
+											  ProgramObject* programObjectPtr,
+											  const u32		 shaderBinaryIndex,
+											  const u32		 shaderIndex)
+	{
+		if ((programId >= MAX_SHADER_PROGRAM_REGISTRY_NUM) || (programObjectPtr == NULL))
+		{
+			NN_TPANIC_("RegisterShaderProgram() failed. Invalid programId = %d\n", programId);
+			return false;
+		}
+
+		if (m_ShaderProgramPtrArray[programId] != NULL)
+		{
+			NN_TLOG_("ShaderManager::RegisterShaderProgram() : programId = %d is in use.\n", programId);
+			return false;
+		}
+
+		if ((shaderBinaryIndex >= MAX_SHADER_BINARY_NUM) || (shaderIndex >= m_ShaderNumArray[shaderBinaryIndex]))
+		{
+			NN_TLOG_("ShaderManager::RegisterShaderProgram() : No shader %d in shader binary %d.\n", shaderIndex, shaderBinaryIndex);
+			return false;
+		}
+
+		if (programObjectPtr->IsInitialized())
+		{
+			NN_TLOG_("ShaderManager::RegisterShaderProgram() : The shader program of programId = %d is already initialized.\n", programId);
+			return false;
+		}
+
+		programObjectPtr->SetUniformLocationTable(&m_UniformLocationTableArray[shaderBinaryIndex]);
+
+		// A title program is linked now, so that a program that cannot be linked is reported to the caller instead of stopping the
+		// first flush that uses it. The basic shaders are linked by the first GetShaderProgram.
+		if ((programId >= BASIC_SHADER_BINARY_SHADER_NUM) && !programObjectPtr->Initialize(m_ShaderIdArray[shaderBinaryIndex][shaderIndex]))
+		{
+			NN_TLOG_("ShaderManager::RegisterShaderProgram() : The shader program of programId = %d cannot be initialized.\n", programId);
+			return false;
+		}
+
+		m_ShaderProgramPtrArray[programId]	= programObjectPtr;
+		m_ShaderBinaryIndexArray[programId] = shaderBinaryIndex;
+		m_ShaderIndexArray[programId]		= shaderIndex;
+
+		return true;
+	}
+
+	bool ShaderManager::UnregisterShaderProgram(const u32 programId)
+	{
+		if ((programId < BASIC_SHADER_BINARY_SHADER_NUM) || (programId >= MAX_SHADER_PROGRAM_REGISTRY_NUM))
+		{
+			return false;
+		}
+
+		ProgramObject* programObjectPtr = m_ShaderProgramPtrArray[programId];
+		if (programObjectPtr == NULL)
+		{
+			return false;
+		}
+
+		programObjectPtr->FinalizeStateCommand();
+		programObjectPtr->Finalize();
+		m_ShaderProgramPtrArray[programId] = NULL;
+
+		// The ID of the deleted program may be reused by a new one, so the state cache must not skip binding it.
+		GetGLStateCache().Invalidate();
 
 		return true;
 	}
@@ -86,38 +241,66 @@ namespace nn { namespace graphics {
 			return false;
 		}
 
-		for (u32 shaderBinaryIndex = 0; shaderBinaryIndex < MAX_SHADER_BINARY_NUM; shaderBinaryIndex++)
+		for (u32 programId = 0; programId < MAX_SHADER_PROGRAM_REGISTRY_NUM; programId++)
 		{
-			for (u32 shaderProgramIndex = 0; shaderProgramIndex < MAX_SHADER_PROGRAM_NUM; shaderProgramIndex++)
+			ProgramObject* programObjectPtr = m_ShaderProgramPtrArray[programId];
+			if (programObjectPtr != NULL)
 			{
-				ProgramObject* programObjectPtr = m_ShaderProgramPtrArray[shaderBinaryIndex][shaderProgramIndex];
-				if (programObjectPtr != NULL)
-				{
-					programObjectPtr->Finalize();
-				}
+				programObjectPtr->FinalizeStateCommand();
+				programObjectPtr->Finalize();
+				m_ShaderProgramPtrArray[programId] = NULL;
 			}
 		}
 
+		for (u32 shaderBinaryIndex = 0; shaderBinaryIndex < MAX_SHADER_BINARY_NUM; shaderBinaryIndex++)
+		{
+			UnloadShaderBinary(shaderBinaryIndex);
+		}
+
+		GetGLStateCache().Invalidate();
+
 		m_Initialized = false;
 
 		return true;
 	}
 
-	u32 ShaderManager::GetVertexAttributes(const ShaderType shaderType)
+	u32 ShaderManager::GetVertexAttributes(const u32 programId)
 	{
-		ProgramObject* shaderProgramPtr = GetShaderProgram(shaderType);
+		// The vertex attributes are known before the program is linked.
+		ProgramObject* shaderProgramPtr = GetRegisteredShaderProgram(programId);
 		return shaderProgramPtr->GetVertexAttributes();
 	}
 
-	ProgramObject* ShaderManager::GetShaderProgram(const ShaderType shaderType)
+	ProgramObject* ShaderManager::GetShaderProgram(const u32 programId)
+	{
+		ProgramObject* shaderProgramPtr = GetRegisteredShaderProgram(programId);
+		if (!shaderProgramPtr->IsInitialized())
+		{
+			u32 shaderBinaryIndex = m_ShaderBinaryIndexArray[programId];
+			if (!shaderProgramPtr->Initialize(m_ShaderIdArray[shaderBinaryIndex][m_ShaderIndexArray[programId]]))
+			{
+				NN_TPANIC_("GetShaderProgram() failed. The shader program of programId = %d cannot be initialized.\n", programId);
+			}
+
+			// The basic shaders are switched between in every flush, so their state is saved as commands.
+			if (programId < BASIC_SHADER_BINARY_SHADER_NUM)
+			{
+				shaderProgramPtr->SaveStateCommand();
+			}
+		}
+
+		return shaderProgramPtr;
+	}
+
+	ProgramObject* ShaderManager::GetRegisteredShaderProgram(const u32 programId)
 	{
-		if ((shaderType == COLOR_FILL_SHADER) || (shaderType == FONT_SHADER) || (shaderType == DECAL_TEXTURE_SHADER))
+		if ((programId < MAX_SHADER_PROGRAM_REGISTRY_NUM) && (m_ShaderProgramPtrArray[programId] != NULL))
 		{
-			return m_ShaderProgramPtrArray[BASIC_SHADER_BINARY_INDEX][shaderType];
+			return m_ShaderProgramPtrArray[programId];
 		}
 		else
 		{
-			NN_TPANIC_("GetShaderProgram() failed. Invalid shaderType = %d\n", shaderType);
+			NN_TPANIC_("GetShaderProgram() failed. Invalid programId = %d\n", programId);
 			return NULL;
 		}
 	}
@@ -0,0 +1,180 @@
+#include "graphics/graphics_SizeClassPool.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		// Number of blocks of each size class. The 4 KB class holds the arrays of the default textured triangles render data.
+		const u32 s_BlockNumArray[detail::SIZE_CLASS_POOL_CLASS_NUM] = {128, 64, 64, 32, 16, 16, 16};
+	}  // namespace
+
+	namespace detail {
+		/* ------------------------------------------------------------------------
+			<tt>SizeClassPool</tt> Class Member Function
+		------------------------------------------------------------------------ */
+
+		SizeClassPool::SizeClassPool(void)
+		: m_InitializeFlag(false)
+		{
+			for (u32 classIndex = 0; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				m_ClassStartAddrArray[classIndex]	= 0;
+				m_pFreeListArray[classIndex]		= NULL;
+				m_UsedBlockNumArray[classIndex]		= 0;
+				m_PeakUsedBlockNumArray[classIndex] = 0;
+				m_ExhaustedNumArray[classIndex]		= 0;
+			}
+			m_ClassStartAddrArray[SIZE_CLASS_POOL_CLASS_NUM] = 0;
+		}
+
+		SizeClassPool::~SizeClassPool(void) { Finalize(); }
+
+		size_t SizeClassPool::GetRequiredSize(void)
+		{
+			size_t requiredSize = 0;
+			for (u32 classIndex = 0; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				requiredSize += GetClassSize(classIndex) * s_BlockNumArray[classIndex];
+			}
+
+			return requiredSize;
+		}
+
+		u32 SizeClassPool::GetClassIndex(const size_t size)
+		{
+			u32 classIndex = 0;
+			for (; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				if (size <= GetClassSize(classIndex))
+				{
+					break;
+				}
+			}
+
+			return classIndex;
+		}
+
+		size_t SizeClassPool::GetClassSize(const u32 classIndex) { return (1 << (SIZE_CLASS_POOL_MIN_CLASS_SIZE_LOG2 + classIndex)); }
+
+		void SizeClassPool::Initialize(void* regionAddr, const size_t regionSize)
+		{
+			if (m_InitializeFlag)
+			{
+				return;
+			}
+
+			if ((regionAddr == NULL) || (regionSize < GetRequiredSize()))
+			{
+				NN_TPANIC_("Invalid region for the size class pool.(0x%08X, 0x%X)\n", regionAddr, regionSize);
+			}
+
+			uptr classStartAddr = reinterpret_cast<uptr>(regionAddr);
+			for (u32 classIndex = 0; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				size_t classSize				  = GetClassSize(classIndex);
+				m_ClassStartAddrArray[classIndex] = classStartAddr;
+
+				// Link the blocks in address order.
+				m_pFreeListArray[classIndex] = NULL;
+				for (u32 blockIndex = s_BlockNumArray[classIndex]; blockIndex > 0; blockIndex--)
+				{
+					void* pBlock					  = reinterpret_cast<void*>(classStartAddr + classSize * (blockIndex - 1));
+					*reinterpret_cast<void**>(pBlock) = m_pFreeListArray[classIndex];
+					m_pFreeListArray[classIndex]	  = pBlock;
+				}
+
+				m_UsedBlockNumArray[classIndex]		= 0;
+				m_PeakUsedBlockNumArray[classIndex] = 0;
+				m_ExhaustedNumArray[classIndex]		= 0;
+
+				classStartAddr += classSize * s_BlockNumArray[classIndex];
+			}
+			m_ClassStartAddrArray[SIZE_CLASS_POOL_CLASS_NUM] = classStartAddr;
+
+			m_InitializeFlag = true;
+		}
+
+		void SizeClassPool::Finalize(void)
+		{
+			if (!m_InitializeFlag)
+			{
+				return;
+			}
+
+			for (u32 classIndex = 0; classIndex <= SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				m_ClassStartAddrArray[classIndex] = 0;
+			}
+
+			m_InitializeFlag = false;
+		}
+
+		void* SizeClassPool::Allocate(const u32 classIndex)
+		{
+			void* pBlock = m_InitializeFlag ? m_pFreeListArray[classIndex] : NULL;
+			if (pBlock == NULL)
+			{
+				return NULL;
+			}
+
+			m_pFreeListArray[classIndex] = *reinterpret_cast<void**>(pBlock);
+			m_UsedBlockNumArray[classIndex]++;
+			if (m_UsedBlockNumArray[classIndex] > m_PeakUsedBlockNumArray[classIndex])
+			{
+				m_PeakUsedBlockNumArray[classIndex] = m_UsedBlockNumArray[classIndex];
+			}
+
+			return pBlock;
+		}
+
+		void SizeClassPool::Free(void* ptr)
+		{
+			u32 classIndex = GetBlockClassIndex(ptr);
+
+			*reinterpret_cast<void**>(ptr) = m_pFreeListArray[classIndex];
+			m_pFreeListArray[classIndex]   = ptr;
+			m_UsedBlockNumArray[classIndex]--;
+		}
+
+		bool SizeClassPool::IsInPool(const void* ptr) const
+		{
+			uptr addr = reinterpret_cast<uptr>(ptr);
+			return m_InitializeFlag && (m_ClassStartAddrArray[0] <= addr) && (addr < m_ClassStartAddrArray[SIZE_CLASS_POOL_CLASS_NUM]);
+		}
+
+		u32 SizeClassPool::GetBlockClassIndex(const void* ptr) const
+		{
+			uptr addr		= reinterpret_cast<uptr>(ptr);
+			u32	 classIndex = 0;
+			while ((classIndex + 1 < SIZE_CLASS_POOL_CLASS_NUM) && (addr >= m_ClassStartAddrArray[classIndex + 1]))
+			{
+				classIndex++;
+			}
+
+			return classIndex;
+		}
+
+		u32 SizeClassPool::GetBlockNum(const u32 classIndex) const { return s_BlockNumArray[classIndex]; }
+
+		u32 SizeClassPool::GetUsedBlockNum(const u32 classIndex) const { return m_UsedBlockNumArray[classIndex]; }
+
+		u32 SizeClassPool::GetPeakUsedBlockNum(const u32 classIndex) const { return m_PeakUsedBlockNumArray[classIndex]; }
+
+		u32 SizeClassPool::GetExhaustedNum(const u32 classIndex) const { return m_ExhaustedNumArray[classIndex]; }
+
+		void SizeClassPool::AddExhaustedNum(const u32 classIndex) { m_ExhaustedNumArray[classIndex]++; }
+
+		void SizeClassPool::Print(void) const
+		{
+			for (u32 classIndex = 0; classIndex < SIZE_CLASS_POOL_CLASS_NUM; classIndex++)
+			{
+				NN_TLOG_("[graphics::SizeClassPool] %4d bytes : used %3d (peak %3d) of %3d, exhausted %d\n",
+						 GetClassSize(classIndex),
+						 m_UsedBlockNumArray[classIndex],
+						 m_PeakUsedBlockNumArray[classIndex],
+						 s_BlockNumArray[classIndex],
+						 m_ExhaustedNumArray[classIndex]);
+			}
+		}
+	}  // namespace detail
+
+}}	// namespace nn::graphics
@@ -0,0 +1,88 @@
+#include "graphics/graphics_ThreadCache.h"
+
+namespace nn { namespace graphics {
+
+	namespace detail {
+		/* ------------------------------------------------------------------------
+			<tt>ThreadCache</tt> Class Member Function
+		------------------------------------------------------------------------ */
+
+		ThreadCache::ThreadCache(void)
+		: m_BoundFlag(false)
+		, m_ThreadId(0)
+		, m_HitNum(0)
+		, m_MissNum(0)
+		{
+			for (u32 classIndex = 0; classIndex < THREAD_CACHE_CLASS_NUM; classIndex++)
+			{
+				m_pFreeListArray[classIndex] = NULL;
+				m_BlockNumArray[classIndex]	 = 0;
+			}
+		}
+
+		ThreadCache::~ThreadCache(void) {}
+
+		void ThreadCache::Bind(const bit32 threadId)
+		{
+			for (u32 classIndex = 0; classIndex < THREAD_CACHE_CLASS_NUM; classIndex++)
+			{
+				m_pFreeListArray[classIndex] = NULL;
+				m_BlockNumArray[classIndex]	 = 0;
+			}
+			m_HitNum  = 0;
+			m_MissNum = 0;
+
+			m_ThreadId	= threadId;
+			m_BoundFlag = true;
+		}
+
+		void ThreadCache::Unbind(void)
+		{
+			m_BoundFlag = false;
+			m_ThreadId	= 0;
+		}
+
+		bool ThreadCache::IsBound(void) const { return m_BoundFlag; }
+
+		bit32 ThreadCache::GetThreadId(void) const { return m_ThreadId; }
+
+		void* ThreadCache::Pop(const u32 classIndex)
+		{
+			void* pBlock = m_pFreeListArray[classIndex];
+			if (pBlock == NULL)
+			{
+				return NULL;
+			}
+
+			m_pFreeListArray[classIndex] = *reinterpret_cast<void**>(pBlock);
+			m_BlockNumArray[classIndex]--;
+
+			return pBlock;
+		}
+
+		bool ThreadCache::Push(const u32 classIndex, void* pBlock)
+		{
+			if (m_BlockNumArray[classIndex] >= THREAD_CACHE_BLOCK_MAX_NUM)
+			{
+				return false;
+			}
+
+			*reinterpret_cast<void**>(pBlock) = m_pFreeListArray[classIndex];
+			m_pFreeListArray[classIndex]	  = pBlock;
+			m_BlockNumArray[classIndex]++;
+
+			return true;
+		}
+
+		u32 ThreadCache::GetBlockNum(const u32 classIndex) const { return m_BlockNumArray[classIndex]; }
+
+		u32 ThreadCache::GetHitNum(void) const { return m_HitNum; }
+
+		u32 ThreadCache::GetMissNum(void) const { return m_MissNum; }
+
+		void ThreadCache::AddHitNum(void) { m_HitNum++; }
+
+		void ThreadCache::AddMissNum(void) { m_MissNum++; }
+	}  // namespace detail
+
+}}	// namespace nn::graphics
@@ -1,7 +1,94 @@
+#include <cstring>
+
 #include "graphics/graphics_TrianglesRenderData.h"
+#include "graphics/graphics_DrawStatistics.h"
+
+// In debug builds, the new part of a vertex or index array is filled with 0xFF bytes. The floats become NaN and the indices
+// 0xFFFF, so a vertex that is drawn without being written shows up at once.
+#if defined(NN_BUILD_DEBUG)
+#define DEBUG_FILL_ARRAYS 1
+#else
+#define DEBUG_FILL_ARRAYS 0
+#endif
 
 namespace nn { namespace graphics {
 
+	namespace {
+		const int DEBUG_FILL_PATTERN = 0xFF;
+
+		// Arrays in the order of the vertex attribute indices, followed by the indices.
+		const u32 INDEX_ARRAY_INDEX = VERTEX_ARRAY_NUM - 1;
+		const u32 s_ArrayAttributeArray[VERTEX_ARRAY_NUM] = {VERTEX_POSITION_ATTRIBUTE,
+															 VERTEX_COLOR_ATTRIBUTE,
+															 VERTEX_TEXCOORD_ATTRIBUTE,
+															 VERTEX_NORMAL_ATTRIBUTE,
+															 VERTEX_TANGENT_ATTRIBUTE,
+															 VERTEX_NONE_ATTRIBUTE};
+		// Number of components per vertex, or indices per triangle.
+		const u32 s_ArrayComponentNumArray[VERTEX_ARRAY_NUM] = {VERTEX_POSITION_ATTRIBUTE_SIZE,
+																VERTEX_COLOR_ATTRIBUTE_SIZE,
+																VERTEX_TEXCOORD_ATTRIBUTE_SIZE,
+																VERTEX_NORMAL_ATTRIBUTE_SIZE,
+																VERTEX_TANGENT_ATTRIBUTE_SIZE,
+																3};
+		// Bytes per vertex, or per triangle.
+		const u32 s_ArrayElementSizeArray[VERTEX_ARRAY_NUM] = {VERTEX_POSITION_ATTRIBUTE_SIZE * 4,
+															   VERTEX_COLOR_ATTRIBUTE_SIZE * 4,
+															   VERTEX_TEXCOORD_ATTRIBUTE_SIZE * 4,
+															   VERTEX_NORMAL_ATTRIBUTE_SIZE * 4,
+															   VERTEX_TANGENT_ATTRIBUTE_SIZE * 4,
+															   3 * 2};
+
+		// Moves an array to a new buffer of newSize bytes, keeping the contents that fit. A size of zero frees the array.
+		void* ResizeArray(void* pArray, const u32 oldSize, const u32 newSize, const char* arrayName)
+		{
+			void* pNewArray = NULL;
+			if (newSize > 0)
+			{
+				pNewArray = graphics::Alloc(newSize);
+				if (pNewArray == NULL)
+				{
+					NN_TPANIC_("%s is NULL.\n", arrayName);
+				}
+
+#if DEBUG_FILL_ARRAYS
+				if (newSize > oldSize)
+				{
+					std::memset(static_cast<u8*>(pNewArray) + oldSize, DEBUG_FILL_PATTERN, newSize - oldSize);
+				}
+#endif
+			}
+
+			if (pArray != NULL)
+			{
+				if (pNewArray != NULL)
+				{
+					std::memcpy(pNewArray, pArray, (oldSize < newSize) ? oldSize : newSize);
+				}
+				graphics::Free(pArray);
+			}
+
+			return pNewArray;
+		}
+
+		// Doubles the capacity until it holds requiredNum elements, without exceeding maxNum.
+		u32 GetGrownCapacity(const u32 capacity, const u32 requiredNum, const u32 maxNum)
+		{
+			if (requiredNum <= capacity)
+			{
+				return capacity;
+			}
+
+			u32 grownCapacity = (capacity > 0) ? capacity : 1;
+			while (grownCapacity < requiredNum)
+			{
+				grownCapacity *= 2;
+			}
+
+			return (grownCapacity < maxNum) ? grownCapacity : maxNum;
+		}
+	}  // namespace
+
 	/* ------------------------------------------------------------------------
 		<tt>TrianglesRenderData</tt> Class Member Function
 	------------------------------------------------------------------------ */
@@ -14,15 +101,17 @@ namespace nn { namespace graphics {
 	, m_TrianglesNum(0)
 	, m_PackedVerticesNum(0)
 	, m_PackedTrianglesNum(0)
+	, m_VertexCapacity(0)
+	, m_TriangleCapacity(0)
+	, m_HighWaterVerticesNum(0)
+	, m_HighWaterTrianglesNum(0)
 	, m_PositionArraySize(0)
 	, m_ColorArraySize(0)
 	, m_TexcoordArraySize(0)
 	, m_NormalArraySize(0)
 	, m_TangentArraySize(0)
 	, m_TotalArraySize(0)
-	, m_OldTotalArraySize(0)
 	, m_IndexArraySize(0)
-	, m_OldIndexArraySize(0)
 	, m_PositionArray(NULL)
 	, m_ColorArray(NULL)
 	, m_TexcoordArray(NULL)
@@ -31,10 +120,14 @@ namespace nn { namespace graphics {
 	, m_IndexArray(NULL)
 	, m_ArrayBufferId(0)
 	, m_ElementArrayBufferId(0)
+	, m_BufferRingNum(1)
+	, m_BufferRingIndex(0)
+	, m_PendingTrimNum(0)
 	, m_InitArrayFlag(false)
 	, m_InitBufferFlag(false)
 	, m_UpdateBufferFlag(true)
 	, m_UpdateAttributesFlag(true)
+	, m_DirectVertexBufferFlag(false)
 	, m_PositionX(0.0f)
 	, m_PositionY(0.0f)
 	, m_PositionZ(0.0f)
@@ -42,6 +135,24 @@ namespace nn { namespace graphics {
 	, m_AngleY(0.0f)
 	, m_AngleZ(0.0f)
 	{
+		for (u32 bufferIndex = 0; bufferIndex < MAX_VERTEX_BUFFER_RING_NUM; bufferIndex++)
+		{
+			m_ArrayBufferIdArray[bufferIndex]		   = 0;
+			m_ElementArrayBufferIdArray[bufferIndex]   = 0;
+			m_ArrayBufferSizeArray[bufferIndex]		   = 0;
+			m_ElementArrayBufferSizeArray[bufferIndex] = 0;
+
+			DirectBuffer& directBuffer		= m_DirectBufferArray[bufferIndex];
+			directBuffer.m_VertexCapacity	= 0;
+			directBuffer.m_TriangleCapacity = 0;
+			for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+			{
+				directBuffer.m_pArrayArray[arrayIndex]		= NULL;
+				directBuffer.m_BufferIdArray[arrayIndex]	= 0;
+				directBuffer.m_pBoundArrayArray[arrayIndex] = NULL;
+				directBuffer.m_BoundSizeArray[arrayIndex]	= 0;
+			}
+		}
 	}
 
 	TrianglesRenderData::~TrianglesRenderData(void) { Finalize(); }
@@ -82,106 +193,14 @@ namespace nn { namespace graphics {
 	{
 		DestroyArrays();
 
-		m_TotalArraySize	= 0;
-		m_OldTotalArraySize = 0;
-
-		if (m_VertexAttributes & VERTEX_POSITION_ATTRIBUTE)
-		{
-			m_PositionArray = (f32*)graphics::Alloc(m_VerticesNum * 4 * 4);
-			if (m_PositionArray == NULL)
-			{
-				NN_TPANIC_("m_PositionArray is NULL.\n");
-			}
-
-			for (u32 i = 0; i < m_VerticesNum; i++)
-			{
-				m_PositionArray[4 * i]	   = 0.0f;
-				m_PositionArray[4 * i + 1] = 0.0f;
-				m_PositionArray[4 * i + 2] = 0.0f;
-				m_PositionArray[4 * i + 3] = 1.0f;
-			}
-		}
-
-		if (m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE)
-		{
-			m_ColorArray = (f32*)graphics::Alloc(m_VerticesNum * 4 * 4);
-			if (m_ColorArray == NULL)
-			{
-				NN_TPANIC_("m_ColorArray is NULL.\n");
-			}
-
-			for (u32 i = 0; i < m_VerticesNum; i++)
-			{
-				m_ColorArray[4 * i]		= 0.0f;
-				m_ColorArray[4 * i + 1] = 0.0f;
-				m_ColorArray[4 * i + 2] = 0.0f;
-				m_ColorArray[4 * i + 3] = 1.0f;
-			}
-		}
-
-		if (m_VertexAttributes & VERTEX_TEXCOORD_ATTRIBUTE)
-		{
-			m_TexcoordArray = (f32*)graphics::Alloc(m_VerticesNum * 3 * 4);
-			if (m_TexcoordArray == NULL)
-			{
-				NN_TPANIC_("m_TexcoordArray is NULL.\n");
-			}
-
-			for (u32 i = 0; i < m_VerticesNum; i++)
-			{
-				m_TexcoordArray[3 * i]	   = 0.0f;
-				m_TexcoordArray[3 * i + 1] = 0.0f;
-				m_TexcoordArray[3 * i + 2] = 0.0f;
-			}
-		}
-
-		if (m_VertexAttributes & VERTEX_NORMAL_ATTRIBUTE)
-		{
-			m_NormalArray = (f32*)graphics::Alloc(m_VerticesNum * 3 * 4);
-			if (m_NormalArray == NULL)
-			{
-				NN_TPANIC_("m_NormalArray is NULL.\n");
-			}
-
-			for (u32 i = 0; i < m_VerticesNum; i++)
-			{
-				m_NormalArray[3 * i]	 = 0.0f;
-				m_NormalArray[3 * i + 1] = 0.0f;
-				m_NormalArray[3 * i + 2] = 1.0f;
-			}
-		}
-
-		if (m_VertexAttributes & VERTEX_TANGENT_ATTRIBUTE)
-		{
-			m_TangentArray = (f32*)graphics::Alloc(m_VerticesNum * 3 * 4);
-			if (m_TangentArray == NULL)
-			{
-				NN_TPANIC_("m_TangentArray is NULL.\n");
-			}
-
-			for (u32 i = 0; i < m_VerticesNum; i++)
-			{
-				m_TangentArray[3 * i]	  = 1.0f;
-				m_TangentArray[3 * i + 1] = 0.0f;
-				m_TangentArray[3 * i + 2] = 0.0f;
-			}
-		}
+		m_TotalArraySize = 0;
+		m_IndexArraySize = 0;
 
-		m_IndexArraySize	= 0;
-		m_OldIndexArraySize = 0;
-
-		m_IndexArray = (GLushort*)graphics::Alloc(m_TrianglesNum * 3 * 2);
-		if (m_IndexArray == NULL)
-		{
-			NN_TPANIC_("m_IndexArray is NULL.\n");
-		}
-
-		for (u32 i = 0; i < m_TrianglesNum; i++)
-		{
-			m_IndexArray[3 * i]		= 0;
-			m_IndexArray[3 * i + 1] = 0;
-			m_IndexArray[3 * i + 2] = 0;
-		}
+		// The arrays start with room for a few triangles and grow as they are packed.
+		// They are not initialized: every packed vertex and index is written before it is uploaded.
+		u32 triangleCapacity = (m_TrianglesNum < INITIAL_TRIANGLES_NUM) ? m_TrianglesNum : INITIAL_TRIANGLES_NUM;
+		u32 vertexCapacity	 = (m_VerticesNum < 3 * INITIAL_TRIANGLES_NUM) ? m_VerticesNum : 3 * INITIAL_TRIANGLES_NUM;
+		ResizeArrays(vertexCapacity, triangleCapacity);
 
 		m_InitArrayFlag = true;
 	}
@@ -195,6 +214,23 @@ namespace nn { namespace graphics {
 
 		m_InitArrayFlag = false;
 
+		// The arrays of the other entries of the ring are freed here; those of the current entry below.
+		for (u32 bufferIndex = 0; bufferIndex < MAX_VERTEX_BUFFER_RING_NUM; bufferIndex++)
+		{
+			DirectBuffer& directBuffer = m_DirectBufferArray[bufferIndex];
+			for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+			{
+				if ((bufferIndex != m_BufferRingIndex) && (directBuffer.m_pArrayArray[arrayIndex] != NULL))
+				{
+					graphics::Free(directBuffer.m_pArrayArray[arrayIndex]);
+				}
+				directBuffer.m_pArrayArray[arrayIndex] = NULL;
+			}
+			directBuffer.m_VertexCapacity	= 0;
+			directBuffer.m_TriangleCapacity = 0;
+		}
+		m_PendingTrimNum = 0;
+
 		if (m_PositionArray != NULL)
 		{
 			graphics::Free((void*)m_PositionArray);
@@ -237,21 +273,138 @@ namespace nn { namespace graphics {
 		m_ColorArraySize	= 0;
 		m_TangentArraySize	= 0;
 		m_TotalArraySize	= 0;
-		m_OldTotalArraySize = 0;
-
 		m_IndexArraySize	= 0;
-		m_OldIndexArraySize = 0;
+
+		m_VertexCapacity		= 0;
+		m_TriangleCapacity		= 0;
+		m_HighWaterVerticesNum	= 0;
+		m_HighWaterTrianglesNum = 0;
+	}
+
+	void TrianglesRenderData::ReserveArrays(const u32 verticesNum, const u32 trianglesNum)
+	{
+		if (verticesNum > m_HighWaterVerticesNum)
+		{
+			m_HighWaterVerticesNum = verticesNum;
+		}
+
+		if (trianglesNum > m_HighWaterTrianglesNum)
+		{
+			m_HighWaterTrianglesNum = trianglesNum;
+		}
+
+		u32 vertexCapacity	 = GetGrownCapacity(m_VertexCapacity, verticesNum, m_VerticesNum);
+		u32 triangleCapacity = GetGrownCapacity(m_TriangleCapacity, trianglesNum, m_TrianglesNum);
+		if ((vertexCapacity != m_VertexCapacity) || (triangleCapacity != m_TriangleCapacity))
+		{
+			ResizeArrays(vertexCapacity, triangleCapacity);
+		}
 	}
 
-	void TrianglesRenderData::SetPackedVerticesNum(const u32 packedVerticesNum) { m_PackedVerticesNum = packedVerticesNum; }
+	void TrianglesRenderData::ResizeArrays(const u32 vertexCapacity, const u32 triangleCapacity)
+	{
+		if (vertexCapacity != m_VertexCapacity)
+		{
+			if (m_VertexAttributes & VERTEX_POSITION_ATTRIBUTE)
+			{
+				m_PositionArray = static_cast<GLfloat*>(ResizeArray(m_PositionArray,
+																	m_VertexCapacity * VERTEX_POSITION_ATTRIBUTE_SIZE * 4,
+																	vertexCapacity * VERTEX_POSITION_ATTRIBUTE_SIZE * 4,
+																	"m_PositionArray"));
+			}
+
+			if (m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE)
+			{
+				m_ColorArray = static_cast<GLfloat*>(ResizeArray(m_ColorArray,
+																 m_VertexCapacity * VERTEX_COLOR_ATTRIBUTE_SIZE * 4,
+																 vertexCapacity * VERTEX_COLOR_ATTRIBUTE_SIZE * 4,
+																 "m_ColorArray"));
+			}
+
+			if (m_VertexAttributes & VERTEX_TEXCOORD_ATTRIBUTE)
+			{
+				m_TexcoordArray = static_cast<GLfloat*>(ResizeArray(m_TexcoordArray,
+																	m_VertexCapacity * VERTEX_TEXCOORD_ATTRIBUTE_SIZE * 4,
+																	vertexCapacity * VERTEX_TEXCOORD_ATTRIBUTE_SIZE * 4,
+																	"m_TexcoordArray"));
+			}
+
+			if (m_VertexAttributes & VERTEX_NORMAL_ATTRIBUTE)
+			{
+				m_NormalArray = static_cast<GLfloat*>(ResizeArray(m_NormalArray,
+																  m_VertexCapacity * VERTEX_NORMAL_ATTRIBUTE_SIZE * 4,
+																  vertexCapacity * VERTEX_NORMAL_ATTRIBUTE_SIZE * 4,
+																  "m_NormalArray"));
+			}
+
+			if (m_VertexAttributes & VERTEX_TANGENT_ATTRIBUTE)
+			{
+				m_TangentArray = static_cast<GLfloat*>(ResizeArray(m_TangentArray,
+																   m_VertexCapacity * VERTEX_TANGENT_ATTRIBUTE_SIZE * 4,
+																   vertexCapacity * VERTEX_TANGENT_ATTRIBUTE_SIZE * 4,
+																   "m_TangentArray"));
+			}
+
+			m_VertexCapacity = vertexCapacity;
+		}
+
+		if (triangleCapacity != m_TriangleCapacity)
+		{
+			m_IndexArray = static_cast<GLushort*>(ResizeArray(m_IndexArray, m_TriangleCapacity * 3 * 2, triangleCapacity * 3 * 2, "m_IndexArray"));
 
-	void TrianglesRenderData::AddPackedVerticesNum(const u32 packedVerticesNum) { m_PackedVerticesNum += packedVerticesNum; }
+			m_TriangleCapacity = triangleCapacity;
+		}
+	}
+
+	void TrianglesRenderData::TrimArrays(void)
+	{
+		if (!m_InitArrayFlag)
+		{
+			return;
+		}
+
+		ShrinkArraysToHighWater();
+
+		// The arrays of the other entries of the ring may be read by the GPU now. They are trimmed when they become current.
+		if (m_DirectVertexBufferFlag)
+		{
+			m_PendingTrimNum = m_BufferRingNum - 1;
+		}
+	}
+
+	void TrianglesRenderData::ShrinkArraysToHighWater(void)
+	{
+		u32 vertexCapacity	 = (m_HighWaterVerticesNum < m_VertexCapacity) ? m_HighWaterVerticesNum : m_VertexCapacity;
+		u32 triangleCapacity = (m_HighWaterTrianglesNum < m_TriangleCapacity) ? m_HighWaterTrianglesNum : m_TriangleCapacity;
+		ResizeArrays(vertexCapacity, triangleCapacity);
+	}
+
+	void TrianglesRenderData::SetPackedVerticesNum(const u32 packedVerticesNum)
+	{
+		m_PackedVerticesNum = packedVerticesNum;
+		// The packed vertices are uploaded, so they must be in the arrays.
+		ReserveArrays(m_PackedVerticesNum, 0);
+	}
+
+	void TrianglesRenderData::AddPackedVerticesNum(const u32 packedVerticesNum)
+	{
+		m_PackedVerticesNum += packedVerticesNum;
+		ReserveArrays(m_PackedVerticesNum, 0);
+	}
 
 	u32 TrianglesRenderData::GetPackedVerticesNum(void) const { return m_PackedVerticesNum; }
 
-	void TrianglesRenderData::SetPackedTrianglesNum(const u32 packedTrianglesNum) { m_PackedTrianglesNum = packedTrianglesNum; }
+	void TrianglesRenderData::SetPackedTrianglesNum(const u32 packedTrianglesNum)
+	{
+		m_PackedTrianglesNum = packedTrianglesNum;
+		ReserveArrays(0, m_PackedTrianglesNum);
+	}
 
-	void TrianglesRenderData::AddPackedTrianglesNum(const u32 packedTrianglesNum) { m_PackedTrianglesNum += packedTrianglesNum; }
+	void TrianglesRenderData::AddPackedTrianglesNum(const u32 packedTrianglesNum)
+	{
+		m_PackedTrianglesNum += packedTrianglesNum;
+		ReserveArrays(0, m_PackedTrianglesNum);
+	}
 
 	u32 TrianglesRenderData::GetPackedTrianglesNum(void) const { return m_PackedTrianglesNum; }
 
@@ -262,6 +415,72 @@ namespace nn { namespace graphics {
 		if (packedTrianglesNum != 0)
 		{
 			Draw();
+
+			// The GPU reads these arrays until the command list has run, so the next primitives go to the next entry of the ring.
+			if (m_DirectVertexBufferFlag)
+			{
+				SwapDirectBuffer();
+			}
+		}
+		ClearPackedNum();
+	}
+
+	void TrianglesRenderData::BeginPackedDraw(void)
+	{
+		SetPackedArraysSize();
+		if (!m_InitArrayFlag || (GetPackedTrianglesNum() == 0))
+		{
+			return;
+		}
+
+		// The arrays are uploaded, or written back from the CPU cache, once for all the ranges.
+		if (m_DirectVertexBufferFlag)
+		{
+			BindDirectBuffers();
+		}
+		else if (m_UpdateBufferFlag)
+		{
+			UpdateBuffers();
+		}
+	}
+
+	void TrianglesRenderData::DrawPackedRange(const u32 firstIndex, const u32 indicesNum)
+	{
+		if (!m_InitArrayFlag || (indicesNum == 0))
+		{
+			return;
+		}
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		// Other render data may have been drawn since the last range, so the buffers are bound again.
+		if (m_DirectVertexBufferFlag)
+		{
+			EnableDirectVertexAttributes();
+		}
+		else
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, m_ArrayBufferId);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ElementArrayBufferId);
+
+			if (m_UpdateAttributesFlag)
+			{
+				EnableVertexAttributes();
+			}
+		}
+
+		glDrawElements(m_TriangleType, indicesNum, GL_UNSIGNED_SHORT, reinterpret_cast<GLvoid*>(firstIndex * sizeof(GLushort)));
+		GetCurrentDrawStatistics().m_DrawCallNum += 1;
+
+		GRAPHICS_ASSERT_GL_ERROR();
+	}
+
+	void TrianglesRenderData::EndPackedDraw(void)
+	{
+		// As in <tt>DrawPackedTriangles</tt>, the next primitives go to the next entry of the ring.
+		if (m_DirectVertexBufferFlag && m_InitArrayFlag && (GetPackedTrianglesNum() != 0))
+		{
+			SwapDirectBuffer();
 		}
 		ClearPackedNum();
 	}
@@ -274,8 +493,7 @@ namespace nn { namespace graphics {
 
 	void TrianglesRenderData::SetPackedArraysSize(void)
 	{
-		m_OldTotalArraySize = m_TotalArraySize;
-		m_TotalArraySize	= 0;
+		m_TotalArraySize = 0;
 
 		if (m_VertexAttributes & VERTEX_POSITION_ATTRIBUTE)
 		{
@@ -327,28 +545,34 @@ namespace nn { namespace graphics {
 			m_TangentArraySize = 0;
 		}
 
-		m_OldIndexArraySize = m_IndexArraySize;
-		m_IndexArraySize	= m_PackedTrianglesNum * 3 * 2;
+		m_IndexArraySize = m_PackedTrianglesNum * 3 * 2;
 	}
 
 	void TrianglesRenderData::UpdateBuffers(void)
 	{
 		u32 array_offset = 0;
 
+		// Upload to the next buffers of the ring. The GPU may still read the previous ones from a command list in flight.
+		m_BufferRingIndex	   = (m_BufferRingIndex + 1) % m_BufferRingNum;
+		m_ArrayBufferId		   = m_ArrayBufferIdArray[m_BufferRingIndex];
+		m_ElementArrayBufferId = m_ElementArrayBufferIdArray[m_BufferRingIndex];
+
 		if (m_ArrayBufferId == 0)
 		{
 			glGenBuffers(1, &m_ArrayBufferId);
 			GRAPHICS_ASSERT_GL_ERROR();
+
+			m_ArrayBufferIdArray[m_BufferRingIndex] = m_ArrayBufferId;
 		}
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_ArrayBufferId);
 
 		// Allocate <tt>ARRAY_BUFFER</tt>.
-		if (m_TotalArraySize > m_OldTotalArraySize)
+		if (m_TotalArraySize > m_ArrayBufferSizeArray[m_BufferRingIndex])
 		{
 			glBufferData(ARRAY_BUFFER_DATA_TYPE, m_TotalArraySize, 0, GL_STATIC_DRAW);
 
-			m_OldTotalArraySize = m_TotalArraySize;
+			m_ArrayBufferSizeArray[m_BufferRingIndex] = m_TotalArraySize;
 		}
 
 		// Copy <tt>POSITION</tt>.
@@ -390,6 +614,8 @@ namespace nn { namespace graphics {
 		{
 			glGenBuffers(1, &m_ElementArrayBufferId);
 			GRAPHICS_ASSERT_GL_ERROR();
+
+			m_ElementArrayBufferIdArray[m_BufferRingIndex] = m_ElementArrayBufferId;
 		}
 
 		GRAPHICS_ASSERT_GL_ERROR();
@@ -397,10 +623,10 @@ namespace nn { namespace graphics {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ElementArrayBufferId);
 
 		// Allocate <tt>ELEMENT_ARRAY_BUFFER</tt>.
-		if (m_IndexArraySize > m_OldIndexArraySize)
+		if (m_IndexArraySize > m_ElementArrayBufferSizeArray[m_BufferRingIndex])
 		{
 			glBufferData(ELEMENT_ARRAY_BUFFER_DATA_TYPE, m_IndexArraySize, NULL, GL_STATIC_DRAW);
-			m_OldIndexArraySize = m_IndexArraySize;
+			m_ElementArrayBufferSizeArray[m_BufferRingIndex] = m_IndexArraySize;
 
 			GRAPHICS_ASSERT_GL_ERROR();
 		}
@@ -408,6 +634,9 @@ namespace nn { namespace graphics {
 		// Copy <tt>ELEMENT_ARRAY_BUFFER</tt>.
 		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_IndexArraySize, m_IndexArray);
 
+		GetCurrentDrawStatistics().m_UploadedVertexBytes += array_offset;
+		GetCurrentDrawStatistics().m_UploadedIndexBytes += m_IndexArraySize;
+
 		GRAPHICS_ASSERT_GL_ERROR();
 
 		m_InitBufferFlag = true;
@@ -415,6 +644,38 @@ namespace nn { namespace graphics {
 
 	void TrianglesRenderData::SetUpdateBufferBeforeDraw(const bool updateBufferFlag) { m_UpdateBufferFlag = updateBufferFlag; }
 
+	void TrianglesRenderData::SetVertexBufferRingNum(const u32 bufferRingNum)
+	{
+		if ((bufferRingNum == 0) || (bufferRingNum > MAX_VERTEX_BUFFER_RING_NUM))
+		{
+			NN_TPANIC_("bufferRingNum(%d) must be 1 to %d.\n", bufferRingNum, MAX_VERTEX_BUFFER_RING_NUM);
+		}
+
+		if (bufferRingNum == m_BufferRingNum)
+		{
+			return;
+		}
+
+		// The arrays of the ring entries are not moved to another ring.
+		if (m_DirectVertexBufferFlag && m_InitArrayFlag)
+		{
+			NN_TPANIC_("SetVertexBufferRingNum() must be called before InitializeVertexBuffers() in direct vertex buffer mode.\n");
+		}
+
+		DestroyBuffers();
+		m_BufferRingNum = bufferRingNum;
+	}
+
+	void TrianglesRenderData::SetDirectVertexBuffer(const bool directFlag)
+	{
+		if (m_InitArrayFlag)
+		{
+			NN_TPANIC_("SetDirectVertexBuffer() must be called before InitializeVertexBuffers().\n");
+		}
+
+		m_DirectVertexBufferFlag = directFlag;
+	}
+
 	void TrianglesRenderData::DestroyBuffers(void)
 	{
 		if (!m_InitBufferFlag)
@@ -424,16 +685,42 @@ namespace nn { namespace graphics {
 
 		GRAPHICS_ASSERT_GL_ERROR();
 
-		if (m_ArrayBufferId != 0)
+		for (u32 bufferIndex = 0; bufferIndex < MAX_VERTEX_BUFFER_RING_NUM; bufferIndex++)
 		{
-			glDeleteBuffers(1, &m_ArrayBufferId);
-			m_ArrayBufferId = 0;
+			if (m_ArrayBufferIdArray[bufferIndex] != 0)
+			{
+				glDeleteBuffers(1, &m_ArrayBufferIdArray[bufferIndex]);
+				m_ArrayBufferIdArray[bufferIndex] = 0;
+			}
+
+			if (m_ElementArrayBufferIdArray[bufferIndex] != 0)
+			{
+				glDeleteBuffers(1, &m_ElementArrayBufferIdArray[bufferIndex]);
+				m_ElementArrayBufferIdArray[bufferIndex] = 0;
+			}
+
+			m_ArrayBufferSizeArray[bufferIndex]		   = 0;
+			m_ElementArrayBufferSizeArray[bufferIndex] = 0;
+
+			DirectBuffer& directBuffer = m_DirectBufferArray[bufferIndex];
+			for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+			{
+				if (directBuffer.m_BufferIdArray[arrayIndex] != 0)
+				{
+					glDeleteBuffers(1, &directBuffer.m_BufferIdArray[arrayIndex]);
+					directBuffer.m_BufferIdArray[arrayIndex] = 0;
+				}
+				directBuffer.m_pBoundArrayArray[arrayIndex] = NULL;
+				directBuffer.m_BoundSizeArray[arrayIndex]	= 0;
+			}
 		}
 
-		if (m_ElementArrayBufferId != 0)
+		m_ArrayBufferId		   = 0;
+		m_ElementArrayBufferId = 0;
+		// In direct vertex buffer mode, the ring index tells which entry the current arrays belong to.
+		if (!m_DirectVertexBufferFlag || !m_InitArrayFlag)
 		{
-			glDeleteBuffers(1, &m_ElementArrayBufferId);
-			m_ElementArrayBufferId = 0;
+			m_BufferRingIndex = 0;
 		}
 
 		GRAPHICS_ASSERT_GL_ERROR();
@@ -441,10 +728,168 @@ namespace nn { namespace graphics {
 		m_InitBufferFlag = false;
 	}
 
+	void TrianglesRenderData::SwapDirectBuffer(void)
+	{
+		DirectBuffer& currentBuffer = m_DirectBufferArray[m_BufferRingIndex];
+		for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+		{
+			currentBuffer.m_pArrayArray[arrayIndex] = GetArray(arrayIndex);
+		}
+		currentBuffer.m_VertexCapacity	 = m_VertexCapacity;
+		currentBuffer.m_TriangleCapacity = m_TriangleCapacity;
+
+		m_BufferRingIndex = (m_BufferRingIndex + 1) % m_BufferRingNum;
+
+		DirectBuffer& nextBuffer = m_DirectBufferArray[m_BufferRingIndex];
+		for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+		{
+			SetArray(arrayIndex, nextBuffer.m_pArrayArray[arrayIndex]);
+			nextBuffer.m_pArrayArray[arrayIndex] = NULL;
+		}
+		m_VertexCapacity   = nextBuffer.m_VertexCapacity;
+		m_TriangleCapacity = nextBuffer.m_TriangleCapacity;
+
+		if (m_PendingTrimNum > 0)
+		{
+			m_PendingTrimNum--;
+			ShrinkArraysToHighWater();
+		}
+	}
+
+	void TrianglesRenderData::BindDirectBuffers(void)
+	{
+		DirectBuffer& directBuffer = m_DirectBufferArray[m_BufferRingIndex];
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		for (u32 arrayIndex = 0; arrayIndex < VERTEX_ARRAY_NUM; arrayIndex++)
+		{
+			bool isIndexArray = (arrayIndex == INDEX_ARRAY_INDEX);
+			if (!isIndexArray && !(m_VertexAttributes & s_ArrayAttributeArray[arrayIndex]))
+			{
+				continue;
+			}
+
+			const void* pArray = GetArray(arrayIndex);
+			if (pArray == NULL)
+			{
+				continue;
+			}
+
+			GLenum target	  = isIndexArray ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+			u32	   arraySize  = (isIndexArray ? m_TriangleCapacity : m_VertexCapacity) * s_ArrayElementSizeArray[arrayIndex];
+			u32	   packedSize = (isIndexArray ? m_PackedTrianglesNum : m_PackedVerticesNum) * s_ArrayElementSizeArray[arrayIndex];
+
+			if (directBuffer.m_BufferIdArray[arrayIndex] == 0)
+			{
+				glGenBuffers(1, &directBuffer.m_BufferIdArray[arrayIndex]);
+				GRAPHICS_ASSERT_GL_ERROR();
+			}
+
+			glBindBuffer(target, directBuffer.m_BufferIdArray[arrayIndex]);
+
+			// Register the array itself as the buffer. This is redone only when the array has been moved by a resize.
+			if ((pArray != directBuffer.m_pBoundArrayArray[arrayIndex]) || (arraySize != directBuffer.m_BoundSizeArray[arrayIndex]))
+			{
+				glBufferData(target, arraySize, pArray, GL_STATIC_DRAW | NN_GX_MEM_FCRAM | GL_NO_COPY_FCRAM_DMP);
+				GRAPHICS_ASSERT_GL_ERROR();
+
+				directBuffer.m_pBoundArrayArray[arrayIndex] = pArray;
+				directBuffer.m_BoundSizeArray[arrayIndex]	= arraySize;
+			}
+
+			// Write the packed part back from the CPU cache so that the GPU reads what was written.
+			nngxUpdateBuffer(pArray, packedSize);
+		}
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		m_InitBufferFlag = true;
+	}
+
+	void TrianglesRenderData::EnableDirectVertexAttributes(void)
+	{
+		DirectBuffer& directBuffer = m_DirectBufferArray[m_BufferRingIndex];
+		u32			  attrib_index = 0;
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		// Each attribute has its own buffer, starting at offset 0.
+		for (u32 arrayIndex = 0; arrayIndex < INDEX_ARRAY_INDEX; arrayIndex++)
+		{
+			if (m_VertexAttributes & s_ArrayAttributeArray[arrayIndex])
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, directBuffer.m_BufferIdArray[arrayIndex]);
+				glEnableVertexAttribArray(attrib_index);
+				glVertexAttribPointer(attrib_index, s_ArrayComponentNumArray[arrayIndex], GL_FLOAT, GL_FALSE, 0, 0);
+
+				attrib_index += 1;
+			}
+		}
+
+		for (u32 i = attrib_index; i < 8; i++)
+		{
+			glDisableVertexAttribArray(i);
+		}
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, directBuffer.m_BufferIdArray[INDEX_ARRAY_INDEX]);
+
+		GRAPHICS_ASSERT_GL_ERROR();
+	}
+
+	void* TrianglesRenderData::GetArray(const u32 arrayIndex) const
+	{
+		switch (arrayIndex)
+		{
+			case 0:
+				return m_PositionArray;
+			case 1:
+				return m_ColorArray;
+			case 2:
+				return m_TexcoordArray;
+			case 3:
+				return m_NormalArray;
+			case 4:
+				return m_TangentArray;
+			default:
+				return m_IndexArray;
+		}
+	}
+
+	void TrianglesRenderData::SetArray(const u32 arrayIndex, void* pArray)
+	{
+		switch (arrayIndex)
+		{
+			case 0:
+				m_PositionArray = static_cast<GLfloat*>(pArray);
+				break;
+			case 1:
+				m_ColorArray = static_cast<GLfloat*>(pArray);
+				break;
+			case 2:
+				m_TexcoordArray = static_cast<GLfloat*>(pArray);
+				break;
+			case 3:
+				m_NormalArray = static_cast<GLfloat*>(pArray);
+				break;
+			case 4:
+				m_TangentArray = static_cast<GLfloat*>(pArray);
+				break;
+			default:
+				m_IndexArray = static_cast<GLushort*>(pArray);
+				break;
+		}
+	}
+
 	void TrianglesRenderData::SetPosition(const u32 index, const GLfloat positionX, const GLfloat positionY, const GLfloat positionZ)
 	{
 		if ((m_VertexAttributes & VERTEX_POSITION_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_PositionArray[4 * index]	   = positionX;
 			m_PositionArray[4 * index + 1] = positionY;
 			m_PositionArray[4 * index + 2] = positionZ;
@@ -464,6 +909,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_POSITION_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_PositionArray[4 * index]	   = positionX;
 			m_PositionArray[4 * index + 1] = positionY;
 			m_PositionArray[4 * index + 2] = positionZ;
@@ -479,6 +929,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_ColorArray[4 * index]		= red;
 			m_ColorArray[4 * index + 1] = green;
 			m_ColorArray[4 * index + 2] = blue;
@@ -494,6 +949,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_ColorArray[4 * index]		= red;
 			m_ColorArray[4 * index + 1] = green;
 			m_ColorArray[4 * index + 2] = blue;
@@ -509,6 +969,8 @@ namespace nn { namespace graphics {
 	{
 		if (m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE)
 		{
+			// Every vertex gets the color, including those the arrays have not grown to yet.
+			ReserveArrays(m_VerticesNum, 0);
 			for (u32 index = 0; index < m_VerticesNum; index++)
 			{
 				m_ColorArray[4 * index]		= red;
@@ -527,6 +989,8 @@ namespace nn { namespace graphics {
 	{
 		if (m_VertexAttributes & VERTEX_COLOR_ATTRIBUTE)
 		{
+			// Every vertex gets the color, including those the arrays have not grown to yet.
+			ReserveArrays(m_VerticesNum, 0);
 			for (u32 index = 0; index < m_VerticesNum; index++)
 			{
 				m_ColorArray[4 * index]		= red;
@@ -545,6 +1009,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_TEXCOORD_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_TexcoordArray[3 * index]	   = texcoordS;
 			m_TexcoordArray[3 * index + 1] = texcoordT;
 			m_TexcoordArray[3 * index + 2] = 1.0f;
@@ -559,6 +1028,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_TEXCOORD_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_TexcoordArray[3 * index]	   = texcoordS;
 			m_TexcoordArray[3 * index + 1] = texcoordT;
 			m_TexcoordArray[3 * index + 2] = texcoordR;
@@ -573,6 +1047,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_NORMAL_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_NormalArray[3 * index]	 = normalX;
 			m_NormalArray[3 * index + 1] = normalY;
 			m_NormalArray[3 * index + 2] = normalZ;
@@ -587,6 +1066,11 @@ namespace nn { namespace graphics {
 	{
 		if ((m_VertexAttributes & VERTEX_TANGENT_ATTRIBUTE) && (index < m_VerticesNum))
 		{
+			if (index >= m_VertexCapacity)
+			{
+				ReserveArrays(index + 1, 0);
+			}
+
 			m_TangentArray[3 * index]	  = tangentX;
 			m_TangentArray[3 * index + 1] = tangentY;
 			m_TangentArray[3 * index + 2] = tangentZ;
@@ -601,6 +1085,11 @@ namespace nn { namespace graphics {
 	{
 		if (index < m_TrianglesNum)
 		{
+			if (index >= m_TriangleCapacity)
+			{
+				ReserveArrays(0, index + 1);
+			}
+
 			m_IndexArray[3 * index]		= static_cast<GLushort>(index0);
 			m_IndexArray[3 * index + 1] = static_cast<GLushort>(index1);
 			m_IndexArray[3 * index + 2] = static_cast<GLushort>(index2);
@@ -621,6 +1110,12 @@ namespace nn { namespace graphics {
 
 		if (squareIndex6 <= m_TrianglesNum)
 		{
+			// The six indices of the quadrangle must fit in the index array, which holds three indices per triangle.
+			if (squareIndex6 + 6 > 3 * m_TriangleCapacity)
+			{
+				ReserveArrays(0, (squareIndex6 + 6 + 2) / 3);
+			}
+
 			// Degenerate triangle.
 			if (squareIndex != 0)
 			{
@@ -706,6 +1201,15 @@ namespace nn { namespace graphics {
 			return;
 		}
 
+		// The GPU reads the arrays themselves, so there is nothing to upload.
+		if (m_DirectVertexBufferFlag)
+		{
+			BindDirectBuffers();
+			EnableDirectVertexAttributes();
+			DrawElements();
+			return;
+		}
+
 		if (m_UpdateBufferFlag)
 		{
 			UpdateBuffers();
@@ -731,11 +1235,13 @@ namespace nn { namespace graphics {
 		{
 			u32 indices_num = m_PackedTrianglesNum * 3;
 			glDrawElements(GL_TRIANGLES, indices_num, GL_UNSIGNED_SHORT, 0);
+			GetCurrentDrawStatistics().m_DrawCallNum += 1;
 		}
 		else if (m_TriangleType == GL_TRIANGLE_STRIP)
 		{
 			u32 indices_num = 6 * (m_PackedTrianglesNum / 4);
 			glDrawElements(GL_TRIANGLE_STRIP, indices_num, GL_UNSIGNED_SHORT, 0);
+			GetCurrentDrawStatistics().m_DrawCallNum += 1;
 		}
 
 		GRAPHICS_ASSERT_GL_ERROR();
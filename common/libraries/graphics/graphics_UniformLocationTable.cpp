@@ -0,0 +1,91 @@
+#include "graphics/graphics_UniformLocationTable.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		// Names of the uniforms in the order of <tt>ProgramUniform</tt>.
+		const char* const s_UniformNameArray[PROGRAM_UNIFORMS_NUM] = {"uProjection",
+																	  "uModelView",
+																	  "dmp_FragOperation.enableAlphaTest",
+																	  "dmp_Texture[0].samplerType",
+																	  "dmp_Texture[1].samplerType",
+																	  "dmp_Texture[2].samplerType",
+																	  "dmp_Texture[3].samplerType",
+																	  "dmp_TexEnv[2].srcRgb",
+																	  "dmp_TexEnv[2].srcAlpha",
+																	  "dmp_TexEnv[2].operandRgb",
+																	  "dmp_TexEnv[2].operandAlpha",
+																	  "dmp_TexEnv[2].combineRgb",
+																	  "dmp_TexEnv[2].combineAlpha",
+																	  "dmp_TexEnv[2].constRgba"};
+	}  // namespace
+
+	/* ------------------------------------------------------------------------
+		<tt>UniformLocationTable</tt> Class Member Function
+	------------------------------------------------------------------------ */
+
+	UniformLocationTable::UniformLocationTable(void) : m_Initialized(false), m_CheckFlag(true) { Finalize(); }
+
+	UniformLocationTable::~UniformLocationTable(void) {}
+
+	bool UniformLocationTable::Initialize(const GLuint programId)
+	{
+		if (programId == 0)
+		{
+			NN_TPANIC_("programId is 0.\n");
+			return false;
+		}
+
+		if (m_Initialized)
+		{
+			if (!m_CheckFlag)
+			{
+				return true;
+			}
+
+			// A title vertex shader may bind its uniforms to other registers than the first program of the binary.
+			for (u32 uniformIndex = 0; uniformIndex < PROGRAM_UNIFORMS_NUM; uniformIndex++)
+			{
+				GLint location = glGetUniformLocation(programId, s_UniformNameArray[uniformIndex]);
+				if (location != m_LocationArray[uniformIndex])
+				{
+					NN_TLOG_("UniformLocationTable::Initialize() : The location of %s differs between the programs of a shader binary. "
+							 "(%d != %d)\n",
+							 s_UniformNameArray[uniformIndex],
+							 location,
+							 m_LocationArray[uniformIndex]);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		for (u32 uniformIndex = 0; uniformIndex < PROGRAM_UNIFORMS_NUM; uniformIndex++)
+		{
+			m_LocationArray[uniformIndex] = glGetUniformLocation(programId, s_UniformNameArray[uniformIndex]);
+		}
+
+		GRAPHICS_ASSERT_GL_ERROR();
+
+		m_Initialized = true;
+
+		return true;
+	}
+
+	void UniformLocationTable::Finalize(void)
+	{
+		for (u32 uniformIndex = 0; uniformIndex < PROGRAM_UNIFORMS_NUM; uniformIndex++)
+		{
+			m_LocationArray[uniformIndex] = -1;
+		}
+
+		m_Initialized = false;
+		m_CheckFlag	  = true;
+	}
+
+	void UniformLocationTable::SetCheckFlag(const bool flag) { m_CheckFlag = flag; }
+
+	GLint UniformLocationTable::GetLocation(const u32 uniformIndex) const { return m_LocationArray[uniformIndex]; }
+
+}}	// namespace nn::graphics
@@ -0,0 +1,468 @@
+#include "graphics/graphics_VramAllocator.h"
+
+namespace nn { namespace graphics {
+
+	namespace {
+		inline uptr RoundUp(const uptr value, const u32 alignment) { return (value + (alignment - 1)) & ~(static_cast<uptr>(alignment) - 1); }
+
+		// Gets the index of the most significant bit set. <tt>value</tt> must not be 0.
+		u32 Fls(u32 value)
+		{
+			u32 index = 0;
+			if (value & 0xFFFF0000)
+			{
+				value >>= 16;
+				index += 16;
+			}
+			if (value & 0x0000FF00)
+			{
+				value >>= 8;
+				index += 8;
+			}
+			if (value & 0x000000F0)
+			{
+				value >>= 4;
+				index += 4;
+			}
+			if (value & 0x0000000C)
+			{
+				value >>= 2;
+				index += 2;
+			}
+			if (value & 0x00000002)
+			{
+				index += 1;
+			}
+
+			return index;
+		}
+
+		// Gets the index of the least significant bit set. <tt>value</tt> must not be 0.
+		inline u32 Ffs(const u32 value) { return Fls(value & (~value + 1)); }
+
+		// Gets the size class of a block. <tt>size</tt> must be at least <tt>VRAM_ALLOCATOR_MIN_ALIGNMENT</tt>.
+		inline void GetSizeClass(const size_t size, u32* pFlIndex, u32* pSlIndex)
+		{
+			u32 flIndex = Fls(size);
+			*pFlIndex	= flIndex;
+			*pSlIndex	= (size >> (flIndex - detail::VRAM_ALLOCATOR_SL_INDEX_LOG2)) - detail::VRAM_ALLOCATOR_SL_INDEX_NUM;
+		}
+	}  // namespace
+
+	namespace detail {
+		/* ------------------------------------------------------------------------
+			<tt>VramAllocator</tt> Class Member Function
+		------------------------------------------------------------------------ */
+
+		VramAllocator::VramAllocator(void)
+		: m_InitializeFlag(false)
+		, m_StartAddr(0)
+		, m_TotalSize(0)
+		, m_UsedSize(0)
+		, m_PeakUsedSize(0)
+		, m_AllocatedBlockNum(0)
+		, m_FreeBlockNum(0)
+		, m_FlBitmap(0)
+		, m_pFirstBlock(NULL)
+		, m_pSpareBlock(NULL)
+		{
+		}
+
+		VramAllocator::~VramAllocator(void) { Finalize(); }
+
+		void VramAllocator::Initialize(const uptr startAddr, const size_t size)
+		{
+			if (m_InitializeFlag)
+			{
+				return;
+			}
+
+			m_StartAddr = RoundUp(startAddr, VRAM_ALLOCATOR_MIN_ALIGNMENT);
+			m_TotalSize = (size - (m_StartAddr - startAddr)) & ~(VRAM_ALLOCATOR_MIN_ALIGNMENT - 1);
+
+			m_UsedSize			= 0;
+			m_PeakUsedSize		= 0;
+			m_AllocatedBlockNum = 0;
+			m_FreeBlockNum		= 0;
+
+			m_FlBitmap = 0;
+			for (u32 flIndex = 0; flIndex < VRAM_ALLOCATOR_FL_INDEX_NUM; flIndex++)
+			{
+				m_SlBitmapArray[flIndex] = 0;
+				for (u32 slIndex = 0; slIndex < VRAM_ALLOCATOR_SL_INDEX_NUM; slIndex++)
+				{
+					m_pFreeBlockArray2d[flIndex][slIndex] = NULL;
+				}
+			}
+
+			m_pSpareBlock = NULL;
+			for (u32 i = 0; i < VRAM_ALLOCATOR_BLOCK_MAX_NUM; i++)
+			{
+				ReleaseSpareBlock(&m_BlockArray[i]);
+			}
+
+			// The whole region starts as a single free block.
+			m_pFirstBlock				   = GetSpareBlock();
+			m_pFirstBlock->m_Addr		   = m_StartAddr;
+			m_pFirstBlock->m_Size		   = m_TotalSize;
+			m_pFirstBlock->m_pPrevPhysical = NULL;
+			m_pFirstBlock->m_pNextPhysical = NULL;
+			InsertFreeBlock(m_pFirstBlock);
+
+			m_InitializeFlag = true;
+		}
+
+		void VramAllocator::Finalize(void)
+		{
+			if (m_InitializeFlag)
+			{
+				m_pFirstBlock = NULL;
+				m_pSpareBlock = NULL;
+
+				m_InitializeFlag = false;
+			}
+		}
+
+		void* VramAllocator::Allocate(const size_t size, const u32 alignment, const GLenum aim, const GLuint id)
+		{
+			if (!m_InitializeFlag || (size == 0))
+			{
+				return NULL;
+			}
+
+			// Splitting the leading padding and the trailing remainder needs up to two spare blocks.
+			if ((m_pSpareBlock == NULL) || (m_pSpareBlock->m_pNextFree == NULL))
+			{
+				NN_TLOG_("[graphics::VramAllocator] Lack of block. Increase VRAM_ALLOCATOR_BLOCK_MAX_NUM.\n");
+				return NULL;
+			}
+
+			u32	   blockAlignment = (alignment > VRAM_ALLOCATOR_MIN_ALIGNMENT) ? alignment : VRAM_ALLOCATOR_MIN_ALIGNMENT;
+			size_t blockSize	  = RoundUp(size, VRAM_ALLOCATOR_MIN_ALIGNMENT);
+
+			// Free blocks are always aligned to VRAM_ALLOCATOR_MIN_ALIGNMENT, so the padding needed for a larger alignment is bounded.
+			Block* pBlock = FindFreeBlock(blockSize + (blockAlignment - VRAM_ALLOCATOR_MIN_ALIGNMENT));
+			if (pBlock == NULL)
+			{
+				return NULL;
+			}
+			RemoveFreeBlock(pBlock);
+
+			size_t paddingSize = RoundUp(pBlock->m_Addr, blockAlignment) - pBlock->m_Addr;
+			if (paddingSize > 0)
+			{
+				Block* pAlignedBlock = SplitBlock(pBlock, paddingSize);
+				InsertFreeBlock(pBlock);
+				pBlock = pAlignedBlock;
+			}
+
+			if (pBlock->m_Size - blockSize >= VRAM_ALLOCATOR_MIN_ALIGNMENT)
+			{
+				InsertFreeBlock(SplitBlock(pBlock, blockSize));
+			}
+
+			pBlock->m_FreeFlag = false;
+			pBlock->m_Aim	   = aim;
+			pBlock->m_Id	   = id;
+
+			m_UsedSize += pBlock->m_Size;
+			if (m_UsedSize > m_PeakUsedSize)
+			{
+				m_PeakUsedSize = m_UsedSize;
+			}
+			m_AllocatedBlockNum++;
+
+			return reinterpret_cast<void*>(pBlock->m_Addr);
+		}
+
+		bool VramAllocator::Free(void* addr, const GLenum aim, const GLuint id)
+		{
+			if (!m_InitializeFlag || !IsInRegion(addr))
+			{
+				return false;
+			}
+
+			// Blocks are not indexed by address; the physical list is short enough for frees, which are rare compared to draws.
+			Block* pBlock = m_pFirstBlock;
+			for (; pBlock != NULL; pBlock = pBlock->m_pNextPhysical)
+			{
+				if (pBlock->m_Addr == reinterpret_cast<uptr>(addr))
+				{
+					break;
+				}
+			}
+
+			if ((pBlock == NULL) || pBlock->m_FreeFlag)
+			{
+				return false;
+			}
+
+			if ((pBlock->m_Aim != aim) || (pBlock->m_Id != id))
+			{
+				NN_TLOG_("[graphics::VramAllocator] 0x%08X was allocated for (aim 0x%X, id %d) but freed for (aim 0x%X, id %d).\n",
+						 pBlock->m_Addr,
+						 pBlock->m_Aim,
+						 pBlock->m_Id,
+						 aim,
+						 id);
+			}
+
+			m_UsedSize -= pBlock->m_Size;
+			m_AllocatedBlockNum--;
+
+			pBlock->m_FreeFlag = true;
+
+			Block* pPrevBlock = pBlock->m_pPrevPhysical;
+			if ((pPrevBlock != NULL) && pPrevBlock->m_FreeFlag)
+			{
+				RemoveFreeBlock(pPrevBlock);
+				pBlock = MergeBlock(pPrevBlock, pBlock);
+			}
+
+			Block* pNextBlock = pBlock->m_pNextPhysical;
+			if ((pNextBlock != NULL) && pNextBlock->m_FreeFlag)
+			{
+				RemoveFreeBlock(pNextBlock);
+				pBlock = MergeBlock(pBlock, pNextBlock);
+			}
+
+			InsertFreeBlock(pBlock);
+
+			return true;
+		}
+
+		bool VramAllocator::CanAllocate(const size_t size, const u32 alignment) const
+		{
+			if (!m_InitializeFlag || (m_pSpareBlock == NULL) || (m_pSpareBlock->m_pNextFree == NULL))
+			{
+				return false;
+			}
+
+			u32 blockAlignment = (alignment > VRAM_ALLOCATOR_MIN_ALIGNMENT) ? alignment : VRAM_ALLOCATOR_MIN_ALIGNMENT;
+			return RoundUp(size, VRAM_ALLOCATOR_MIN_ALIGNMENT) + (blockAlignment - VRAM_ALLOCATOR_MIN_ALIGNMENT) <= GetLargestFreeBlockSize();
+		}
+
+		bool VramAllocator::IsInRegion(const void* addr) const
+		{
+			uptr address = reinterpret_cast<uptr>(addr);
+			return (m_StartAddr <= address) && (address < m_StartAddr + m_TotalSize);
+		}
+
+		size_t VramAllocator::GetTotalSize(void) const { return m_TotalSize; }
+
+		size_t VramAllocator::GetUsedSize(void) const { return m_UsedSize; }
+
+		size_t VramAllocator::GetPeakUsedSize(void) const { return m_PeakUsedSize; }
+
+		size_t VramAllocator::GetFreeSize(void) const { return m_TotalSize - m_UsedSize; }
+
+		size_t VramAllocator::GetLargestFreeBlockSize(void) const
+		{
+			if (m_FlBitmap == 0)
+			{
+				return 0;
+			}
+
+			// The largest free block is in the highest non-empty size class.
+			u32	   flIndex	  = Fls(m_FlBitmap);
+			u32	   slIndex	  = Fls(m_SlBitmapArray[flIndex]);
+			size_t largestSize = 0;
+			for (Block* pBlock = m_pFreeBlockArray2d[flIndex][slIndex]; pBlock != NULL; pBlock = pBlock->m_pNextFree)
+			{
+				if (pBlock->m_Size > largestSize)
+				{
+					largestSize = pBlock->m_Size;
+				}
+			}
+
+			return largestSize;
+		}
+
+		u32 VramAllocator::GetFreeBlockNum(void) const { return m_FreeBlockNum; }
+
+		u32 VramAllocator::GetAllocatedBlockNum(void) const { return m_AllocatedBlockNum; }
+
+		u32 VramAllocator::GetFragmentationPercent(void) const
+		{
+			size_t freeSize = GetFreeSize();
+			if (freeSize == 0)
+			{
+				return 0;
+			}
+
+			return static_cast<u32>((static_cast<u64>(freeSize - GetLargestFreeBlockSize()) * 100) / freeSize);
+		}
+
+		void VramAllocator::Print(const char* name) const
+		{
+			NN_TLOG_("[graphics::VramAllocator] %s : used 0x%06X (peak 0x%06X) of 0x%06X, %d blocks\n",
+					 name,
+					 m_UsedSize,
+					 m_PeakUsedSize,
+					 m_TotalSize,
+					 m_AllocatedBlockNum);
+			NN_TLOG_("[graphics::VramAllocator] %s : free 0x%06X in %d blocks, largest 0x%06X, fragmentation %d%%\n",
+					 name,
+					 GetFreeSize(),
+					 m_FreeBlockNum,
+					 GetLargestFreeBlockSize(),
+					 GetFragmentationPercent());
+		}
+
+		VramAllocator::Block* VramAllocator::GetSpareBlock(void)
+		{
+			Block* pBlock = m_pSpareBlock;
+			if (pBlock != NULL)
+			{
+				m_pSpareBlock	   = pBlock->m_pNextFree;
+				pBlock->m_pNextFree = NULL;
+				pBlock->m_pPrevFree = NULL;
+			}
+
+			return pBlock;
+		}
+
+		void VramAllocator::ReleaseSpareBlock(Block* pBlock)
+		{
+			pBlock->m_Addr			= 0;
+			pBlock->m_Size			= 0;
+			pBlock->m_pPrevPhysical = NULL;
+			pBlock->m_pNextPhysical = NULL;
+			pBlock->m_pPrevFree		= NULL;
+			pBlock->m_pNextFree		= m_pSpareBlock;
+			pBlock->m_Aim			= 0;
+			pBlock->m_Id			= 0;
+			pBlock->m_FreeFlag		= false;
+
+			m_pSpareBlock = pBlock;
+		}
+
+		void VramAllocator::InsertFreeBlock(Block* pBlock)
+		{
+			u32 flIndex = 0;
+			u32 slIndex = 0;
+			GetSizeClass(pBlock->m_Size, &flIndex, &slIndex);
+
+			Block* pHeadBlock	= m_pFreeBlockArray2d[flIndex][slIndex];
+			pBlock->m_FreeFlag	= true;
+			pBlock->m_pPrevFree = NULL;
+			pBlock->m_pNextFree = pHeadBlock;
+			if (pHeadBlock != NULL)
+			{
+				pHeadBlock->m_pPrevFree = pBlock;
+			}
+			m_pFreeBlockArray2d[flIndex][slIndex] = pBlock;
+
+			m_FlBitmap |= (1 << flIndex);
+			m_SlBitmapArray[flIndex] |= (1 << slIndex);
+			m_FreeBlockNum++;
+		}
+
+		void VramAllocator::RemoveFreeBlock(Block* pBlock)
+		{
+			u32 flIndex = 0;
+			u32 slIndex = 0;
+			GetSizeClass(pBlock->m_Size, &flIndex, &slIndex);
+
+			if (pBlock->m_pPrevFree != NULL)
+			{
+				pBlock->m_pPrevFree->m_pNextFree = pBlock->m_pNextFree;
+			}
+			else
+			{
+				m_pFreeBlockArray2d[flIndex][slIndex] = pBlock->m_pNextFree;
+			}
+			if (pBlock->m_pNextFree != NULL)
+			{
+				pBlock->m_pNextFree->m_pPrevFree = pBlock->m_pPrevFree;
+			}
+			pBlock->m_pPrevFree = NULL;
+			pBlock->m_pNextFree = NULL;
+
+			if (m_pFreeBlockArray2d[flIndex][slIndex] == NULL)
+			{
+				m_SlBitmapArray[flIndex] &= ~(1 << slIndex);
+				if (m_SlBitmapArray[flIndex] == 0)
+				{
+					m_FlBitmap &= ~(1 << flIndex);
+				}
+			}
+			m_FreeBlockNum--;
+		}
+
+		VramAllocator::Block* VramAllocator::FindFreeBlock(const size_t size)
+		{
+			u32 flIndex = 0;
+			u32 slIndex = 0;
+
+			// Round the size up to the next size class so that any block of the class found is large enough.
+			size_t searchSize = size + (1 << (Fls(size) - VRAM_ALLOCATOR_SL_INDEX_LOG2)) - 1;
+			GetSizeClass(searchSize, &flIndex, &slIndex);
+
+			if (flIndex < VRAM_ALLOCATOR_FL_INDEX_NUM)
+			{
+				u32 slBitmap = m_SlBitmapArray[flIndex] & (~0U << slIndex);
+				if (slBitmap == 0)
+				{
+					u32 flBitmap = (flIndex + 1 < VRAM_ALLOCATOR_FL_INDEX_NUM) ? (m_FlBitmap & (~0U << (flIndex + 1))) : 0;
+					if (flBitmap != 0)
+					{
+						flIndex	 = Ffs(flBitmap);
+						slBitmap = m_SlBitmapArray[flIndex];
+					}
+				}
+
+				if (slBitmap != 0)
+				{
+					return m_pFreeBlockArray2d[flIndex][Ffs(slBitmap)];
+				}
+			}
+
+			// The size class of the request itself can still hold a block large enough, as when most of the bank is requested.
+			GetSizeClass(size, &flIndex, &slIndex);
+			for (Block* pBlock = m_pFreeBlockArray2d[flIndex][slIndex]; pBlock != NULL; pBlock = pBlock->m_pNextFree)
+			{
+				if (pBlock->m_Size >= size)
+				{
+					return pBlock;
+				}
+			}
+
+			return NULL;
+		}
+
+		VramAllocator::Block* VramAllocator::SplitBlock(Block* pBlock, const size_t size)
+		{
+			Block* pNextBlock = GetSpareBlock();
+
+			pNextBlock->m_Addr			= pBlock->m_Addr + size;
+			pNextBlock->m_Size			= pBlock->m_Size - size;
+			pNextBlock->m_pPrevPhysical = pBlock;
+			pNextBlock->m_pNextPhysical = pBlock->m_pNextPhysical;
+			if (pBlock->m_pNextPhysical != NULL)
+			{
+				pBlock->m_pNextPhysical->m_pPrevPhysical = pNextBlock;
+			}
+
+			pBlock->m_Size			= size;
+			pBlock->m_pNextPhysical = pNextBlock;
+
+			return pNextBlock;
+		}
+
+		VramAllocator::Block* VramAllocator::MergeBlock(Block* pBlock, Block* pNextBlock)
+		{
+			pBlock->m_Size += pNextBlock->m_Size;
+			pBlock->m_pNextPhysical = pNextBlock->m_pNextPhysical;
+			if (pNextBlock->m_pNextPhysical != NULL)
+			{
+				pNextBlock->m_pNextPhysical->m_pPrevPhysical = pBlock;
+			}
+
+			ReleaseSpareBlock(pNextBlock);
+
+			return pBlock;
+		}
+	}  // namespace detail
+
+}}	// namespace nn::graphics
@@ -32,6 +32,8 @@ initialize(void)
 	s_HeapForGx = reinterpret_cast<uptr>(s_AppHeap.Allocate(s_GxHeapSize));
 
 	s_RenderSystem.Initialize(s_HeapForGx, s_GxHeapSize);
+	// The lower screen only changes when text comes from the keyboard, so it is only redrawn then.
+	s_RenderSystem.SetDirtyRegionMode(NN_GX_DISPLAY1, true);
 }
 
 void
@@ -56,7 +58,8 @@ drawDisplay1(void)
 	s_RenderSystem.DrawText(0.0f, 0.0f, "Text from keyboard: %ls", s_kbdText);
 
 	s_RenderSystem.SwapBuffers();  // leaving this out will cause the screen to be black, other render target to "bleed" pixels and will
-								   // cause applet::CloseApplication() to hang indefinitely
+								   // cause applet::CloseApplication() to hang indefinitely. A frame that changed nothing in dirty region
+								   // mode still runs the command list and swaps the display to its last frame.
 }
 
 void
@@ -73,6 +76,9 @@ validateGx()
 	// Validate GX state
 	nngxUpdateState(NN_GX_STATE_ALL);
 	nngxValidateState(NN_GX_STATE_ALL, GL_TRUE);
+
+	// The applet has used the LCDs, so the next frame is drawn and displayed in full.
+	s_RenderSystem.InvalidateDirtyRegion(NN_GX_DISPLAY_BOTH);
 }
 
 AppletQueryReply